@@ -0,0 +1,137 @@
+#ifndef ATTACKGEN_H
+#define ATTACKGEN_H
+
+#include "types.h"
+
+#include <cstddef>
+
+// Reference slider helpers shared by the table generator (tablegen.cpp) and the
+// lookup validation in bitboard.cpp. Nothing here is used on the hot path except
+// magicTransform, which must match between generation and lookup.
+
+namespace attackgen {
+
+inline int bitScanForward(U64 bb) {
+    return __builtin_ctzll(bb);
+}
+
+// maps bit i of index onto the i-th lowest square of mask (same order as pext)
+inline U64 setOccupancy(int index, int bits, U64 mask) {
+    U64 occupancy = 0ULL;
+    U64 bitboard = mask;
+    for (int i = 0; i < bits; ++i) {
+        int square = bitScanForward(bitboard);
+        bitboard &= bitboard - 1;
+        if (index & (1 << i)) {
+            occupancy |= (1ULL << square);
+        }
+    }
+    return occupancy;
+}
+
+inline U64 generateRookMask(int square) {
+    U64 mask = 0ULL;
+    int rank = square / 8;
+    int file = square % 8;
+
+    for (int r = rank + 1; r <= 6; ++r) mask |= 1ULL << (r * 8 + file);
+    for (int r = rank - 1; r >= 1; --r) mask |= 1ULL << (r * 8 + file);
+    for (int f = file + 1; f <= 6; ++f) mask |= 1ULL << (rank * 8 + f);
+    for (int f = file - 1; f >= 1; --f) mask |= 1ULL << (rank * 8 + f);
+
+    return mask;
+}
+
+inline U64 generateBishopMask(int square) {
+    U64 mask = 0ULL;
+    int rank = square / 8;
+    int file = square % 8;
+
+    for (int r = rank + 1, f = file + 1; r <= 6 && f <= 6; ++r, ++f)
+        mask |= 1ULL << (r * 8 + f);
+    for (int r = rank + 1, f = file - 1; r <= 6 && f >= 1; ++r, --f)
+        mask |= 1ULL << (r * 8 + f);
+    for (int r = rank - 1, f = file + 1; r >= 1 && f <= 6; --r, ++f)
+        mask |= 1ULL << (r * 8 + f);
+    for (int r = rank - 1, f = file - 1; r >= 1 && f >= 1; --r, --f)
+        mask |= 1ULL << (r * 8 + f);
+
+    return mask;
+}
+
+inline U64 rookAttacksOnTheFly(int square, U64 occupancy) {
+    U64 attacks = 0ULL;
+    int rank = square / 8;
+    int file = square % 8;
+
+    for (int r = rank + 1; r < 8; ++r) {
+        int sq = r * 8 + file;
+        attacks |= 1ULL << sq;
+        if (occupancy & (1ULL << sq)) break;
+    }
+    for (int r = rank - 1; r >= 0; --r) {
+        int sq = r * 8 + file;
+        attacks |= 1ULL << sq;
+        if (occupancy & (1ULL << sq)) break;
+    }
+    for (int f = file + 1; f < 8; ++f) {
+        int sq = rank * 8 + f;
+        attacks |= 1ULL << sq;
+        if (occupancy & (1ULL << sq)) break;
+    }
+    for (int f = file - 1; f >= 0; --f) {
+        int sq = rank * 8 + f;
+        attacks |= 1ULL << sq;
+        if (occupancy & (1ULL << sq)) break;
+    }
+
+    return attacks;
+}
+
+inline U64 bishopAttacksOnTheFly(int square, U64 occupancy) {
+    U64 attacks = 0ULL;
+    int rank = square / 8;
+    int file = square % 8;
+
+    for (int r = rank + 1, f = file + 1; r < 8 && f < 8; ++r, ++f) {
+        int sq = r * 8 + f;
+        attacks |= 1ULL << sq;
+        if (occupancy & (1ULL << sq)) break;
+    }
+    for (int r = rank + 1, f = file - 1; r < 8 && f >= 0; ++r, --f) {
+        int sq = r * 8 + f;
+        attacks |= 1ULL << sq;
+        if (occupancy & (1ULL << sq)) break;
+    }
+    for (int r = rank - 1, f = file + 1; r >= 0 && f < 8; --r, ++f) {
+        int sq = r * 8 + f;
+        attacks |= 1ULL << sq;
+        if (occupancy & (1ULL << sq)) break;
+    }
+    for (int r = rank - 1, f = file - 1; r >= 0 && f >= 0; --r, --f) {
+        int sq = r * 8 + f;
+        attacks |= 1ULL << sq;
+        if (occupancy & (1ULL << sq)) break;
+    }
+
+    return attacks;
+}
+
+constexpr bool kUse32BitMagic = true;
+
+inline size_t magicTransform(U64 blockers, U64 magic, int bits) {
+    if constexpr (kUse32BitMagic) {
+        uint32_t lower = static_cast<uint32_t>(blockers);
+        uint32_t upper = static_cast<uint32_t>(blockers >> 32);
+        uint32_t magicLower = static_cast<uint32_t>(magic);
+        uint32_t magicUpper = static_cast<uint32_t>(magic >> 32);
+        uint32_t product = (lower * magicLower) ^ (upper * magicUpper);
+        return product >> (32 - bits);
+    } else {
+        return static_cast<size_t>((blockers * magic) >> (64 - bits));
+    }
+}
+
+} // namespace attackgen
+
+#endif // ATTACKGEN_H
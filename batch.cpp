@@ -0,0 +1,77 @@
+#include "batch.h"
+#include "evaluation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+namespace batch {
+
+void evaluate(const Board* boards, size_t count, float* evals, float* planes, int threads) {
+    parallelFor(count, threads, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            evals[i] = static_cast<float>(evaluation::evaluateBoard(boards[i]));
+            if (planes) evaluation::piecePlanes(boards[i], planes + i * evaluation::PLANE_SIZE);
+        }
+    });
+}
+
+size_t evaluate(const PackedPosition* positions, size_t count, float* evals, float* planes, int threads) {
+    std::atomic<size_t> invalid(0);
+    parallelFor(count, threads, [=, &invalid](size_t begin, size_t end) {
+        Board board;
+        for (size_t i = begin; i < end; ++i) {
+            if (!board.decode(positions[i])) {
+                evals[i] = std::numeric_limits<float>::quiet_NaN();
+                if (planes) std::memset(planes + i * evaluation::PLANE_SIZE, 0, evaluation::PLANE_SIZE * sizeof(float));
+                invalid++;
+                continue;
+            }
+            evals[i] = static_cast<float>(evaluation::evaluateBoard(board));
+            if (planes) evaluation::piecePlanes(board, planes + i * evaluation::PLANE_SIZE);
+        }
+    });
+    return invalid;
+}
+
+std::vector<Board> parseFens(const std::vector<std::string>& fens, int threads) {
+    std::vector<Board> boards(fens.size());
+    parallelFor(fens.size(), threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) boards[i].setFen(fens[i]); // EPD operations are ignored
+    });
+    return boards;
+}
+
+bool readFenFile(const std::string& path, std::vector<std::string>& fens) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        fens.push_back(line);
+    }
+    return true;
+}
+
+bool readPackedFile(const std::string& path, std::vector<PackedPosition>& positions) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    size_t bytes = static_cast<size_t>(in.tellg());
+    if (bytes % sizeof(PackedPosition) != 0) return false;
+    positions.resize(bytes / sizeof(PackedPosition));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(positions.data()), bytes);
+    return static_cast<bool>(in);
+}
+
+int defaultThreads() {
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw > 0 ? static_cast<int>(hw) : 1;
+}
+
+} // namespace batch
@@ -0,0 +1,60 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "board.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Bulk scoring for training pipelines: many positions in, contiguous float
+// buffers out, work split evenly across threads.
+
+namespace batch {
+
+// runs fn(begin, end) over [0, count) split into one contiguous range per thread
+template <typename Fn>
+void parallelFor(size_t count, int threads, Fn fn) {
+    threads = std::max(1, std::min<int>(threads, static_cast<int>(std::max<size_t>(1, count))));
+    if (threads == 1) {
+        fn(0, count);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    size_t chunk = (count + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        workers.emplace_back(fn, begin, end);
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+// evals[i] = evaluation::evaluateBoard(boards[i]) (white perspective, centipawns).
+// planes, if not null, receives count * evaluation::PLANE_SIZE floats.
+void evaluate(const Board* boards, size_t count, float* evals, float* planes, int threads);
+
+// the same for PackedPosition records, decoded inside the worker threads.
+// Records that do not decode get a NaN eval and all-zero planes; returns how
+// many there were
+size_t evaluate(const PackedPosition* positions, size_t count, float* evals, float* planes, int threads);
+
+// parses FEN/EPD lines (only the board fields are used) in parallel
+std::vector<Board> parseFens(const std::vector<std::string>& fens, int threads);
+
+// reads non-empty, non-comment lines of a FEN/EPD file
+bool readFenFile(const std::string& path, std::vector<std::string>& fens);
+
+// reads a raw stream of PackedPosition records; false if the file size is
+// not a whole number of records
+bool readPackedFile(const std::string& path, std::vector<PackedPosition>& positions);
+
+int defaultThreads();
+
+} // namespace batch
+
+#endif // BATCH_H
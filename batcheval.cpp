@@ -0,0 +1,114 @@
+#include "batch.h"
+#include "evaluation.h"
+#include "movetables.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+// Scores a FEN/EPD file, or with --packed a file of PackedPosition records, in
+// bulk and writes the results as raw little-endian float32 arrays: one eval
+// per position, and optionally 768 plane values per position
+// (evaluation::piecePlanes layout).
+
+void printUsage() {
+    cerr << "usage: batcheval <positions.fen | positions.bin --packed> [--threads N] [--out evals.f32] [--planes planes.f32]" << endl;
+}
+
+bool writeFloats(const string& path, const vector<float>& values) {
+    ofstream out(path, ios::binary);
+    out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    return static_cast<bool>(out);
+}
+
+double perSecond(size_t count, steady_clock::duration elapsed) {
+    double seconds = duration_cast<microseconds>(elapsed).count() / 1e6;
+    return seconds > 0 ? count / seconds : 0.0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    string inputPath = argv[1];
+    string evalPath, planesPath;
+    int threads = batch::defaultThreads();
+    bool packedInput = false;
+
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = max(1, atoi(argv[++i]));
+        } else if (arg == "--out" && i + 1 < argc) {
+            evalPath = argv[++i];
+        } else if (arg == "--planes" && i + 1 < argc) {
+            planesPath = argv[++i];
+        } else if (arg == "--packed") {
+            packedInput = true;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    MoveTables::instance().init();
+
+    vector<float> evals, planes;
+    if (packedInput) {
+        vector<PackedPosition> positions;
+        if (!batch::readPackedFile(inputPath, positions)) {
+            cerr << "could not read " << inputPath << " as packed positions" << endl;
+            return 1;
+        }
+
+        evals.resize(positions.size());
+        planes.resize(planesPath.empty() ? 0 : positions.size() * evaluation::PLANE_SIZE);
+        auto start = steady_clock::now();
+        size_t invalid = batch::evaluate(positions.data(), positions.size(), evals.data(),
+                                         planesPath.empty() ? nullptr : planes.data(), threads);
+        auto evaluated = steady_clock::now();
+
+        cerr << positions.size() << " packed positions, " << threads << " threads" << endl;
+        if (invalid > 0) cerr << invalid << " records did not decode (NaN evals)" << endl;
+        cerr << "decode + eval" << (planesPath.empty() ? "" : " + planes") << ": "
+             << static_cast<long long>(perSecond(positions.size(), evaluated - start)) << " positions/s" << endl;
+    } else {
+        vector<string> fens;
+        if (!batch::readFenFile(inputPath, fens)) {
+            cerr << "could not read " << inputPath << endl;
+            return 1;
+        }
+
+        auto start = steady_clock::now();
+        vector<Board> boards = batch::parseFens(fens, threads);
+        auto parsed = steady_clock::now();
+
+        evals.resize(boards.size());
+        planes.resize(planesPath.empty() ? 0 : boards.size() * evaluation::PLANE_SIZE);
+        batch::evaluate(boards.data(), boards.size(), evals.data(), planesPath.empty() ? nullptr : planes.data(), threads);
+        auto evaluated = steady_clock::now();
+
+        cerr << boards.size() << " positions, " << threads << " threads" << endl;
+        cerr << "parse: " << static_cast<long long>(perSecond(boards.size(), parsed - start)) << " positions/s" << endl;
+        cerr << "eval" << (planesPath.empty() ? "" : " + planes") << ": "
+             << static_cast<long long>(perSecond(boards.size(), evaluated - parsed)) << " positions/s" << endl;
+    }
+
+    if (!evalPath.empty() && !writeFloats(evalPath, evals)) {
+        cerr << "could not write " << evalPath << endl;
+        return 1;
+    }
+    if (!planesPath.empty() && !writeFloats(planesPath, planes)) {
+        cerr << "could not write " << planesPath << endl;
+        return 1;
+    }
+    return 0;
+}
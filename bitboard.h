@@ -3,12 +3,20 @@
 
 #include "types.h"
 
-#include <array>
 #include <cstddef>
-#include <vector>
+
+// slider lookup implementations; PEXT needs BMI2 and is picked at startup when available
+enum class SliderBackend {
+    Magic,
+    Pext
+};
 
 class MagicBitboard {
 public:
+    // total entries over all squares (sum of 2^relevantBits)
+    static constexpr size_t ROOK_TABLE_SIZE = 102400;
+    static constexpr size_t BISHOP_TABLE_SIZE = 5248;
+
     static MagicBitboard& instance() {
         static MagicBitboard instance;
         return instance;
@@ -19,26 +27,46 @@ public:
     U64 rookAttacks(int square, U64 occupancy) const;
     U64 bishopAttacks(int square, U64 occupancy) const;
 
+    // returns false (and keeps the current backend) if the CPU cannot run it
+    bool setBackend(SliderBackend newBackend);
+    SliderBackend getBackend() const { return backend; }
+    static bool cpuSupportsPext();
+    static const char* backendName(SliderBackend b);
+
+    // exhaustive check of every occupancy against the ray-walking reference,
+    // too slow for startup so it only runs from the test target
+    bool validateTables(SliderBackend b) const;
+
 private:
-    MagicBitboard();
-    ~MagicBitboard();
+    MagicBitboard() = default;
+    ~MagicBitboard() = default;
     MagicBitboard(const MagicBitboard&) = delete;
     MagicBitboard& operator=(const MagicBitboard&) = delete;
 
-    U64 rookMasks[64];
-    U64 bishopMasks[64];
-    U64 rookMagics[64];
-    U64 bishopMagics[64];
-    int rookRelevantBits[64];
-    int bishopRelevantBits[64];
+    // generated at build time by tablegen.cpp into tables_generated.cpp
+    static const U64 rookMasks[64];
+    static const U64 bishopMasks[64];
+    static const U64 rookMagics[64];
+    static const U64 bishopMagics[64];
+    static const int rookRelevantBits[64];
+    static const int bishopRelevantBits[64];
+    static const U32 rookOffsets[64];
+    static const U32 bishopOffsets[64];
+
+    static const U64 rookAttackTable[ROOK_TABLE_SIZE];
+    static const U64 bishopAttackTable[BISHOP_TABLE_SIZE];
+
+    // indexed by pext(occupancy, mask), same per-square offsets as the magic tables
+    static const U64 rookPextTable[ROOK_TABLE_SIZE];
+    static const U64 bishopPextTable[BISHOP_TABLE_SIZE];
 
-    std::array<std::vector<U64>, 64> rookAttackTable;
-    std::array<std::vector<U64>, 64> bishopAttackTable;
+    SliderBackend backend = SliderBackend::Magic;
 
-    void generateMasks();
-    void generateAttackTables();
-    bool validateTables() const;
+    U64 rookAttacksMagic(int square, U64 occupancy) const;
+    U64 bishopAttacksMagic(int square, U64 occupancy) const;
+    U64 rookAttacksPext(int square, U64 occupancy) const;
+    U64 bishopAttacksPext(int square, U64 occupancy) const;
 };
 
 
-#endif // BITBOARD_H
\ No newline at end of file
+#endif // BITBOARD_H
@@ -1,159 +1,291 @@
 #include "board.h"
+#include "evaluation.h"
 #include "movetables.h"
 
+#include <algorithm>
 #include <cstring>
-#include <sstream>
 
 using namespace std;
 
-Board::Board(const std::string& fen){
-    clearBoard();
-    gameInfo = 0ULL;
-    hash = 0ULL; // Initialize hash to zero
+Board::Board(std::string_view fen) {
+    setFen(fen);
+}
+
+namespace {
+
+// next space-separated field of a FEN, advancing pos past it
+std::string_view nextField(std::string_view fen, size_t& pos) {
+    while (pos < fen.size() && fen[pos] == ' ') ++pos;
+    size_t begin = pos;
+    while (pos < fen.size() && fen[pos] != ' ') ++pos;
+    return fen.substr(begin, pos - begin);
+}
+
+// zobrist/psqt index (getPieceIndex order) for a FEN piece letter, -1 if invalid
+int pieceIndexFromChar(char c) {
+    switch (c) {
+        case 'P': return 0;  case 'N': return 1;  case 'B': return 2;
+        case 'R': return 3;  case 'Q': return 4;  case 'K': return 5;
+        case 'p': return 6;  case 'n': return 7;  case 'b': return 8;
+        case 'r': return 9;  case 'q': return 10; case 'k': return 11;
+        default: return -1;
+    }
+}
 
+// non-negative decimal number, false for anything else (e.g. EPD operations)
+bool parseNumber(std::string_view field, int& value) {
+    if (field.empty() || field.size() > 5) return false;
+    value = 0;
+    for (char c : field) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
 
-    std::istringstream iss(fen);
-    std::string boardPart, turnPart, castlingPart, epPart, halfmovePart, fullmovePart;
+} // namespace
 
-    // Parse the FEN string
-    iss >> boardPart >> turnPart >> castlingPart >> epPart >> halfmovePart >> fullmovePart;
+inline void Board::placePiece(int pieceIndex, int square, U64& pieceHash) {
+    U64 squareBB = 1ULL << square;
+    pieceBB[pieceIndex < 6 ? nWhite : nBlack] |= squareBB;
+    pieceBB[nPawns + pieceIndex % 6] |= squareBB;
+    pieceHash ^= MoveTables::zobristTable[pieceIndex][square];
+    if (pieceIndex % 6 == 0) pawnHash ^= MoveTables::zobristTable[pieceIndex][square];
+    psqt += evaluation::psqtValue(pieceIndex, square);
+}
 
-    // 1. Piece placement
-    int square = 56; // Start at a8
-    for (char c : boardPart) {
+bool Board::setFen(std::string_view fen) {
+    clearBoard();
+    gameInfo = 0;
+    fullmoveNumber = 1;
+    hash = 0ULL;
+    pawnHash = 0ULL;
+    psqt = PsqtScore();
+
+    size_t pos = 0;
+    std::string_view placement = nextField(fen, pos);
+    std::string_view turn = nextField(fen, pos);
+    std::string_view castling = nextField(fen, pos);
+    std::string_view enPassant = nextField(fen, pos);
+    std::string_view halfmove = nextField(fen, pos);
+    std::string_view fullmove = nextField(fen, pos);
+
+    // 1. Piece placement, from a8 rank by rank. The piece keys and eval terms
+    // are accumulated here rather than by a second pass over the board.
+    bool valid = true;
+    int square = 56;
+    int file = 0;
+    U64 pieceHash = 0ULL;
+    for (char c : placement) {
         if (c == '/') {
-            square -= 16; // Move to next rank
-        } else if (isdigit(c)) {
+            if (file != 8 || square < 16) { valid = false; break; }
+            square -= 16;
+            file = 0;
+            continue;
+        }
+        if (c >= '1' && c <= '8') {
             square += c - '0';
-        } else {
-            loadPiece(c, square);
-            square++;
+            file += c - '0';
+            if (file > 8) { valid = false; break; }
+            continue;
         }
+
+        int pieceIndex = pieceIndexFromChar(c);
+        if (pieceIndex < 0 || file >= 8) { valid = false; break; }
+
+        placePiece(pieceIndex, square, pieceHash);
+        ++square;
+        ++file;
     }
+    if (square != 8 || file != 8) valid = false;
 
     // 2. Turn
-    if (turnPart == "w") {
-        gameInfo |= TURN_MASK; // White to move
-    } else if (turnPart == "b") {
-        gameInfo &= ~TURN_MASK; // Black to move
+    if (turn == "w") {
+        gameInfo |= TURN_MASK;
+    } else if (turn != "b") {
+        valid = false;
     }
 
     // 3. Castling rights
-    for (char c : castlingPart) {
+    for (char c : castling) {
         switch (c) {
             case 'K': gameInfo |= WK_CASTLE; break;
             case 'Q': gameInfo |= WQ_CASTLE; break;
             case 'k': gameInfo |= BK_CASTLE; break;
             case 'q': gameInfo |= BQ_CASTLE; break;
             case '-': break;
+            default: valid = false; break;
         }
     }
-    // 4. Move count (halfmove clock)
-    if (!halfmovePart.empty()) {
-        int moveCount = std::stoi(halfmovePart);
-        gameInfo &= ~MOVE_MASK;
-        gameInfo |= (moveCount << 6) & MOVE_MASK;
-    }
-    
-    // 5. En passant square
-    if (epPart != "-" && !epPart.empty()) {
-        char fileChar = epPart[0];
-        int file = fileChar - 'a';
-        // Store file in en passant bits
-        gameInfo &= ~(EP_IS_SET | EP_FILE_MASK);
-        gameInfo |= EP_IS_SET | ((file << EP_FILE_SHIFT) & EP_FILE_MASK);
-    } else {
-        // No en passant
-        gameInfo &= ~(EP_IS_SET | EP_FILE_MASK); // Clear old ep info
+
+    // 4. En passant square, only the file is stored
+    if (enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h') {
+        gameInfo |= EP_IS_SET | (((enPassant[0] - 'a') << EP_FILE_SHIFT) & EP_FILE_MASK);
+    } else if (enPassant != "-") {
+        valid = false;
     }
 
-    //     // 6. Fullmove number (optional, usually not needed for move generation)
-    // if (!fullmovePart.empty()) {
-    //     int fullmoveNumber = std::stoi(fullmovePart);
-    //     // You can store this in a member variable if you want, but it's not needed for move legality.
-    // }
+    // 5./6. Move counters, optional (EPD has operations here instead)
+    int halfmoveClock = 0;
+    if (parseNumber(halfmove, halfmoveClock)) {
+        gameInfo |= (std::min(halfmoveClock, MAX_HALFMOVE_CLOCK) << MOVE_SHIFT) & MOVE_MASK;
+
+        int fullmoveValue = 0;
+        if (parseNumber(fullmove, fullmoveValue) && fullmoveValue > 0) {
+            fullmoveNumber = static_cast<U16>(std::min(fullmoveValue, 0xFFFF));
+        }
+    }
 
-    calculateHash(); // Calculate the hash for the initial position
-};
+    hash = pieceHash ^ stateHash();
+    return valid;
+}
 
 Board::Board(const Board& other){
     for (int i = 0; i < 8; i++){
         pieceBB[i] = other.pieceBB[i];
     }
     gameInfo = other.gameInfo;
+    fullmoveNumber = other.fullmoveNumber;
     hash = other.hash;
+    pawnHash = other.pawnHash;
+    psqt = other.psqt;
 }
 
 Board::Board(U64 otherPieceBB[8], const U16& otherGameInfo, const U64& otherHash) {
     memcpy(pieceBB, otherPieceBB, 8 * sizeof(U64));
     gameInfo = otherGameInfo;
     hash = otherHash;
+    calculatePawnHash();
+    calculatePsqt();
+}
+
+PackedPosition Board::encode() const {
+    PackedPosition packed = {};
+    packed.occupancy = getAllPieces();
+    packed.gameInfo = gameInfo;
+    packed.fullmoveNumber = fullmoveNumber;
+
+    U64 pieces = packed.occupancy;
+    for (int i = 0; pieces; ++i) {
+        int square = __builtin_ctzll(pieces);
+        pieces &= pieces - 1;
+        packed.pieces[i / 2] |= static_cast<U8>(getPieceIndex(square) << (4 * (i & 1)));
+    }
+    return packed;
+}
+
+bool Board::decode(const PackedPosition& packed) {
+    clearBoard();
+    gameInfo = packed.gameInfo;
+    fullmoveNumber = packed.fullmoveNumber;
+    pawnHash = 0ULL;
+    psqt = PsqtScore();
+
+    if (__builtin_popcountll(packed.occupancy) > 32) return false;
+
+    U64 pieceHash = 0ULL;
+    U64 pieces = packed.occupancy;
+    for (int i = 0; pieces; ++i) {
+        int square = __builtin_ctzll(pieces);
+        pieces &= pieces - 1;
+        int pieceIndex = (packed.pieces[i / 2] >> (4 * (i & 1))) & 0xF;
+        if (pieceIndex >= 12) return false;
+        placePiece(pieceIndex, square, pieceHash);
+    }
+
+    hash = pieceHash ^ stateHash();
+    return true;
 }
 
 std::string Board::toString() const {
+    char buffer[FEN_BUFFER_SIZE];
+    size_t length = writeFen(buffer);
+    return std::string(buffer, length);
+}
+
+namespace {
+
+inline char* writeNumber(char* out, unsigned value) {
+    char digits[5];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (count > 0) *out++ = digits[--count];
+    return out;
+}
+
+} // namespace
+
+size_t Board::writeFen(char* buffer) const {
+    char* out = buffer;
+
+    // mailbox of piece letters, filled from the bitboards in one pass each
+    static const char PIECE_CHARS[] = "PNBRQK";
+    char squares[64] = {0};
+    for (int type = nPawns; type <= nKings; ++type) {
+        for (int colour = nBlack; colour <= nWhite; ++colour) {
+            char letter = PIECE_CHARS[type - nPawns];
+            if (colour == nBlack) letter = static_cast<char>(letter - 'A' + 'a');
+            U64 pieces = pieceBB[type] & pieceBB[colour];
+            while (pieces) {
+                squares[__builtin_ctzll(pieces)] = letter;
+                pieces &= pieces - 1;
+            }
+        }
+    }
 
-    std::string fen;
-    
     // 1. Piece placement (from rank 8 to 1)
     for (int rank = 7; rank >= 0; rank--) {
         int emptyCount = 0;
-        
         for (int file = 0; file < 8; file++) {
-            int square = rank * 8 + file;
-            char piece = pieceToChar(square);
-            
-            if (piece == '.') {
+            char piece = squares[rank * 8 + file];
+            if (!piece) {
                 emptyCount++;
             } else {
                 if (emptyCount > 0) {
-                    fen += std::to_string(emptyCount);
+                    *out++ = static_cast<char>('0' + emptyCount);
                     emptyCount = 0;
                 }
-                fen += piece;
+                *out++ = piece;
             }
         }
-        
-        if (emptyCount > 0) {
-            fen += std::to_string(emptyCount);
-        }
-        
-        if (rank > 0) {
-            fen += '/';
-        }
+        if (emptyCount > 0) *out++ = static_cast<char>('0' + emptyCount);
+        if (rank > 0) *out++ = '/';
     }
-    
+
     // 2. Active color
-    fen += ' ';
-    fen += (gameInfo & TURN_MASK) ? 'w' : 'b';
-    
+    *out++ = ' ';
+    *out++ = (gameInfo & TURN_MASK) ? 'w' : 'b';
+
     // 3. Castling availability
-    fen += ' ';
-    bool hasCastlingRights = false;
-    if (gameInfo & WK_CASTLE) { fen += 'K'; hasCastlingRights = true; }
-    if (gameInfo & WQ_CASTLE) { fen += 'Q'; hasCastlingRights = true; }
-    if (gameInfo & BK_CASTLE) { fen += 'k'; hasCastlingRights = true; }
-    if (gameInfo & BQ_CASTLE) { fen += 'q'; hasCastlingRights = true; }
-    if (!hasCastlingRights) { fen += '-'; }
-    
+    *out++ = ' ';
+    char* castlingStart = out;
+    if (gameInfo & WK_CASTLE) *out++ = 'K';
+    if (gameInfo & WQ_CASTLE) *out++ = 'Q';
+    if (gameInfo & BK_CASTLE) *out++ = 'k';
+    if (gameInfo & BQ_CASTLE) *out++ = 'q';
+    if (out == castlingStart) *out++ = '-';
+
     // 4. En passant target square
-    fen += ' ';
+    *out++ = ' ';
     if (gameInfo & EP_IS_SET) {
         int epFile = (gameInfo & EP_FILE_MASK) >> EP_FILE_SHIFT;
-        int epRank = (gameInfo & TURN_MASK) ? 6 : 3; // If white to move, ep square is on rank 6; if black, rank 3
-        
-        fen += static_cast<char>('a' + epFile);
-        fen += static_cast<char>('0' + epRank);
+        *out++ = static_cast<char>('a' + epFile);
+        *out++ = (gameInfo & TURN_MASK) ? '6' : '3'; // white to move: the pawn skipped rank 6
     } else {
-        fen += '-';
+        *out++ = '-';
     }
-    
-    // 5. Halfmove clock (for 50-move rule)
-    int halfmoveClock = (gameInfo & MOVE_MASK) >> 6; // Using 6 as the shift based on code context
-    fen += ' ' + std::to_string(halfmoveClock);
-    
-    // 6. Fullmove number +++ IMPLEMENT LATER
-    // fen += "";
-    return fen;
+
+    // 5. Halfmove clock, 6. fullmove number
+    *out++ = ' ';
+    out = writeNumber(out, getHalfMoveClock());
+    *out++ = ' ';
+    out = writeNumber(out, fullmoveNumber);
+
+    *out = '\0';
+    return static_cast<size_t>(out - buffer);
 }
 
 
@@ -176,8 +308,14 @@ void Board::calculateHash(){
         }
     }
 
+    hash ^= stateHash();
+}
+
+// side to move, castling and en passant part of the hash
+U64 Board::stateHash() const {
+    U64 key = 0ULL;
     if (!(gameInfo & TURN_MASK)) { // black to move
-        hash ^= moveTables.zobristSideToMove; // XOR for black to move
+        key ^= MoveTables::zobristSideToMove; // XOR for black to move
     }
 
     // castling rights
@@ -186,12 +324,36 @@ void Board::calculateHash(){
     if (gameInfo & WQ_CASTLE) castlingIdx |= 2;
     if (gameInfo & BK_CASTLE) castlingIdx |= 4;
     if (gameInfo & BQ_CASTLE) castlingIdx |= 8;
-    hash ^= moveTables.zobristCastling[castlingIdx];
+    key ^= MoveTables::zobristCastling[castlingIdx];
 
     // en passant file;
     if (gameInfo & EP_IS_SET) {
         int epFile = (gameInfo & EP_FILE_MASK) >> EP_FILE_SHIFT;
-        hash ^= moveTables.zobristEnPassant[epFile];
+        key ^= MoveTables::zobristEnPassant[epFile];
+    }
+    return key;
+}
+
+void Board::calculatePawnHash() {
+    MoveTables &moveTables = MoveTables::instance();
+    pawnHash = 0ULL;
+
+    U64 pawns = pieceBB[nPawns];
+    while (pawns) {
+        int square = __builtin_ctzll(pawns);
+        pawns &= pawns - 1;
+        pawnHash ^= moveTables.zobristTable[getPieceIndex(square)][square];
+    }
+}
+
+void Board::calculatePsqt() {
+    psqt = PsqtScore();
+
+    U64 pieces = getAllPieces();
+    while (pieces) {
+        int square = __builtin_ctzll(pieces);
+        pieces &= pieces - 1;
+        psqt += evaluation::psqtValue(getPieceIndex(square), square);
     }
 }
 
@@ -253,25 +415,6 @@ void Board::coloursTurnToString() const{
     }
 }
 
-void Board::loadPiece(char piece, int square) {
-    
-    if (piece == toupper(piece)) {
-        pieceBB[nWhite] = pieceBB[nWhite] | (1ULL << square);
-    } else {
-        pieceBB[nBlack] = pieceBB[nBlack] | (1ULL << square);
-    }
-
-    piece = toupper(piece);
-    
-    if (piece == 'P') {pieceBB[nPawns] = pieceBB[nPawns] | (1ULL << square); return;}
-    if (piece == 'N') {pieceBB[nKnights] = pieceBB[nKnights] | (1ULL << square); return;}
-    if (piece == 'B') {pieceBB[nBishops] = pieceBB[nBishops] | (1ULL << square); return;}
-    if (piece == 'R') {pieceBB[nRooks] = pieceBB[nRooks] | (1ULL << square); return;}
-    if (piece == 'Q') {pieceBB[nQueens] = pieceBB[nQueens] | (1ULL << square); return;}
-    if (piece == 'K') {pieceBB[nKings] = pieceBB[nKings] | (1ULL << square); return;}
-}
-
-
 char Board::pieceToChar(int square) const {
     if (getWhitePawns() >> square & 1){return 'P';}
     if (getBlackPawns() >> square & 1){return 'p';}
@@ -7,23 +7,66 @@
 #include <iostream>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace std;
 
+// incrementally maintained evaluation terms, white perspective:
+// middlegame/endgame material + piece-square sums and the game phase
+struct PsqtScore {
+    int mg = 0;
+    int eg = 0;
+    int phase = 0;
+
+    PsqtScore& operator+=(const PsqtScore& other) { mg += other.mg; eg += other.eg; phase += other.phase; return *this; }
+    PsqtScore& operator-=(const PsqtScore& other) { mg -= other.mg; eg -= other.eg; phase -= other.phase; return *this; }
+    PsqtScore operator+(const PsqtScore& other) const { PsqtScore r = *this; return r += other; }
+    PsqtScore operator-(const PsqtScore& other) const { PsqtScore r = *this; return r -= other; }
+    bool operator==(const PsqtScore& other) const { return mg == other.mg && eg == other.eg && phase == other.phase; }
+};
+
+// 32-byte position for storage and streaming: the occupancy bitboard, then a
+// 4-bit piece code (getPieceIndex) per occupied square in ascending square
+// order, two per byte low nibble first, then gameInfo and the fullmove number.
+struct PackedPosition {
+    U64 occupancy;
+    U8 pieces[16];
+    U16 gameInfo;
+    U16 fullmoveNumber;
+    U8 reserved[4];     // zero in encode(), free for record formats built on top
+};
+static_assert(sizeof(PackedPosition) == 32, "PackedPosition should be 32 bytes");
+
 class Board {
 public:
     U64 pieceBB[8];
     U16 gameInfo;
+    U16 fullmoveNumber = 1; // starts at 1, incremented after black moves
     U64 hash;
+    U64 pawnHash;   // zobrist key over pawns only, for the pawn hash table
+    PsqtScore psqt; // material + piece-square score and phase, kept incrementally like hash
+
+    // longest FEN writeFen can produce, including the terminating null
+    static const size_t FEN_BUFFER_SIZE = 96;
 
-    Board(const std::string& fen="rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"); 
+    Board(std::string_view fen="rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"); 
     Board(const Board& other);
     Board& operator=(const Board& other) = default;
     
     Board(U64 otherPieceBB[8], const U16& otherGameInfo, const U64& otherHash);
+
+    // parses all six FEN fields (the move counters are optional, EPD operations
+    // after the fourth field are ignored); false if the FEN is malformed
+    bool setFen(std::string_view fen);
+    // writes the FEN into buffer (FEN_BUFFER_SIZE bytes), returns its length
+    size_t writeFen(char* buffer) const;
     std::string toString() const; // FEN representation
 
+    PackedPosition encode() const;
+    // false if the packed data cannot be a board (more than 32 pieces, bad piece code)
+    bool decode(const PackedPosition& packed);
+
     inline int getEnPassantSquare() const {
         if (!(gameInfo & EP_IS_SET)) return -1; // No en passant square
 
@@ -181,6 +224,8 @@ public:
     inline U64 getHash() const { return this->hash; }
 
     void calculateHash(); // calculate the hash for the current board state
+    void calculatePawnHash(); // recompute pawnHash from scratch
+    void calculatePsqt(); // recompute psqt from scratch
 
     void displayBoard() const;
     void displayGameInfo() const; 
@@ -190,7 +235,10 @@ public:
 private:
 
     void clearBoard();
-    void loadPiece(char piece, int square);
+    // sets a piece on an empty square and folds it into the keys and psqt,
+    // for the single-pass setFen/decode (pieceHash excludes the side/castling/ep keys)
+    inline void placePiece(int pieceIndex, int square, U64& pieceHash);
+    U64 stateHash() const;
 
     int colourCode(enumPiece ct) const;
     int pieceCode(enumPiece pt) const;
@@ -2,6 +2,8 @@
 #include "game.h"
 #include "move.h"
 #include "evaluation.h"
+#include "nnue.h"
+#include "pawns.h"
 #include "transposition.h"
 #include "search.h"
 
@@ -32,17 +34,24 @@ struct GoSettings {
     int depth = 0;
     bool infinite = false;
     bool ponder = false;
+    bool reportInfo = true; // per-iteration `info` lines, off for bench
     std::vector<std::string> searchMoveStrings;
 };
 
 struct SearchResult {
     Move bestMove;
     int depthReached = 0;
+    int score = 0;
 };
 
 std::thread g_searchThread;
 std::atomic<bool> g_searchRunning(false);
 
+const std::string DEFAULT_EVAL_FILE = "nn.bin";
+std::string g_evalFile = DEFAULT_EVAL_FILE;
+bool g_useNNUE = false;
+std::string g_evalParamsFile; // empty: built-in evaluation weights
+
 long toLong(const std::string& value, long fallback = -1) {
     try {
         return std::stol(value);
@@ -104,6 +113,15 @@ void printUciIdentification() {
     std::cout << "id name ChessCPP Engine" << std::endl;
     std::cout << "id author Mack Rabeau" << std::endl;
     std::cout << "option name Hash type spin default 64 min 4 max 4096" << std::endl;
+    std::cout << "option name UseNNUE type check default false" << std::endl;
+    std::cout << "option name EvalFile type string default " << DEFAULT_EVAL_FILE << std::endl;
+    if (evaluation::PARAMS_LOADABLE) {
+        std::cout << "option name EvalParams type string default <empty>" << std::endl;
+    }
+    for (const SearchTunable& tunable : searchTunables()) {
+        std::cout << "option name " << tunable.name << " type spin default " << tunable.defaultValue
+                  << " min " << tunable.min << " max " << tunable.max << std::endl;
+    }
     std::cout << "uciok" << std::endl;
 }
 
@@ -261,6 +279,21 @@ private:
     Game& game;
 };
 
+// UCI score: centipawns, or moves to mate from the side to move's view
+std::string formatScore(int score) {
+    if (score > MATE_THRESHOLD) return "mate " + std::to_string((MATE_VALUE - score + 1) / 2);
+    if (score < -MATE_THRESHOLD) return "mate " + std::to_string(-(MATE_VALUE + score) / 2);
+    return "cp " + std::to_string(score);
+}
+
+void printIterationInfo(int depth, int score, Move bestMove) {
+    long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - g_searchStartTime).count();
+    std::cout << "info depth " << depth << " score " << formatScore(score) << " nodes " << g_nodeCount
+              << " time " << elapsedMs << " nps " << g_nodeCount * 1000 / std::max<long>(1, elapsedMs)
+              << " pv " << moveToString(bestMove) << std::endl;
+}
+
 SearchResult runIterativeSearch(Game& game, const GoSettings& settings, const std::vector<Move>& rootFilter) {
     SearchResult result;
     FastModeGuard guard(game);
@@ -273,13 +306,18 @@ SearchResult runIterativeSearch(Game& game, const GoSettings& settings, const st
     resetStopSearchFlag();
 
     const int targetDepth = (settings.depth > 0) ? std::min(settings.depth, MAX_SEARCH_DEPTH) : MAX_SEARCH_DEPTH;
-    const std::vector<Move>* filterPtr = rootFilter.empty() ? nullptr : &rootFilter;
-
-    for (int depth = 1; depth <= targetDepth; ++depth) {
-        Move bestAtDepth = searchAtDepth(game, depth, filterPtr);
-        if (bestAtDepth != MOVE_NONE) {
-            result.bestMove = bestAtDepth;
+    std::vector<RootMove> rootMoves = generateRootMoves(game, rootFilter.empty() ? nullptr : &rootFilter);
+
+    for (int depth = 1; depth <= targetDepth && !rootMoves.empty(); ++depth) {
+        // an interrupted iteration still counts if it completed a move, since
+        // the previous best is always searched first
+        int score = searchRootAspiration(game, rootMoves, depth, result.score);
+        if (score != ROOT_SCORE_NONE) {
+            result.bestMove = rootMoves[0].move;
             result.depthReached = depth;
+            result.score = score;
+            // a partial iteration still moved the best move, so report it
+            if (settings.reportInfo) printIterationInfo(depth, score, rootMoves[0].move);
         }
 
         if (isTimeUp()) {
@@ -292,6 +330,42 @@ SearchResult runIterativeSearch(Game& game, const GoSettings& settings, const st
     return result;
 }
 
+// fixed-depth searches over a fixed position set: total nodes and nps are
+// comparable between builds (`bench [depth]`, also `./engine bench [depth]`)
+const std::vector<std::string> BENCH_FENS = {
+    STARTPOS_FEN,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+};
+const int DEFAULT_BENCH_DEPTH = 6;
+
+void runBench(int depth) {
+    stopActiveSearch();
+
+    long long totalNodes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& fen : BENCH_FENS) {
+        Game benchGame(fen);
+        g_transpositionTable.clear();
+
+        GoSettings settings;
+        settings.depth = depth;
+        settings.infinite = true; // depth is the only limit
+        settings.reportInfo = false;
+        runIterativeSearch(benchGame, settings, {});
+        totalNodes += g_nodeCount;
+    }
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "bench depth " << depth << ": " << totalNodes << " nodes " << elapsedMs << " ms "
+              << totalNodes * 1000 / std::max<long long>(1, elapsedMs) << " nps" << std::endl;
+}
+
 void startSearch(Game& game, const GoSettings& settings, const std::vector<Move>& rootFilter) {
     joinFinishedSearchThreadIfNeeded();
     if (g_searchRunning.load(std::memory_order_acquire)) {
@@ -313,7 +387,45 @@ void startSearch(Game& game, const GoSettings& settings, const std::vector<Move>
     });
 }
 
-void handleSetOption(const std::string& line) {
+// (re)loads the network when it is enabled, falling back to the handcrafted eval
+void applyNNUESettings(Game& game) {
+    g_transpositionTable.clear(); // entries carry static evals of the previous evaluator
+    game.invalidateAccumulators();
+    nnue::setEnabled(false);
+    if (!g_useNNUE) return;
+
+    if (!nnue::loadNetwork(g_evalFile)) {
+        std::cout << "info string could not load network " << g_evalFile
+                  << ", using handcrafted evaluation" << std::endl;
+        return;
+    }
+    nnue::setEnabled(true);
+    std::cout << "info string NNUE evaluation using " << g_evalFile << std::endl;
+}
+
+// installs the handcrafted-eval weights from g_evalParamsFile, or the built-in ones
+void applyEvalParams(Game& game) {
+    evaluation::EvalParams loaded = evaluation::DEFAULT_PARAMS;
+    bool fromFile = !g_evalParamsFile.empty() && g_evalParamsFile != "<empty>";
+    if (fromFile && !evaluation::loadParams(g_evalParamsFile, loaded)) {
+        std::cout << "info string could not load evaluation parameters " << g_evalParamsFile
+                  << ", using built-in weights" << std::endl;
+        fromFile = false;
+    }
+    if (!evaluation::setParams(loaded)) {
+        std::cout << "info string evaluation parameters are fixed in this build" << std::endl;
+        return;
+    }
+
+    // everything that holds scores of the previous weights
+    g_transpositionTable.clear();
+    pawns::threadTable().clear();
+    threadEvalCache().clear();
+    game.board.calculatePsqt();
+    if (fromFile) std::cout << "info string evaluation parameters from " << g_evalParamsFile << std::endl;
+}
+
+void handleSetOption(const std::string& line, Game& game) {
     const auto namePos = line.find("name");
     if (namePos == std::string::npos) return;
 
@@ -332,15 +444,57 @@ void handleSetOption(const std::string& line) {
         return;
     }
 
+    if (name == "UseNNUE") {
+        stopActiveSearch();
+        g_useNNUE = (value == "true");
+        applyNNUESettings(game);
+        return;
+    }
+
+    if (name == "EvalFile") {
+        stopActiveSearch();
+        g_evalFile = value;
+        applyNNUESettings(game);
+        return;
+    }
+
+    if (name == "EvalParams") {
+        stopActiveSearch();
+        g_evalParamsFile = value;
+        applyEvalParams(game);
+        return;
+    }
+
+    if (!value.empty()) {
+        try {
+            int number = std::stoi(value);
+            stopActiveSearch();
+            if (setSearchTunable(name, number)) return;
+        } catch (const std::exception&) {
+        }
+    }
+
     std::cout << "info string unsupported option " << name << std::endl;
 }
 
 } // namespace
 
-int main() {
+int main(int argc, char* argv[]) {
     MoveTables::instance().init();
     Game game(STARTPOS_FEN);
 
+    // ./engine [--params file] [bench [depth]]
+    int arg = 1;
+    if (argc > arg + 1 && std::string(argv[arg]) == "--params") {
+        g_evalParamsFile = argv[arg + 1];
+        applyEvalParams(game);
+        arg += 2;
+    }
+    if (argc > arg && std::string(argv[arg]) == "bench") {
+        runBench(argc > arg + 1 ? toInt(argv[arg + 1], DEFAULT_BENCH_DEPTH) : DEFAULT_BENCH_DEPTH);
+        return 0;
+    }
+
     std::string line;
     while (std::getline(std::cin, line)) {
         line = trim(line);
@@ -381,7 +535,9 @@ int main() {
             stopActiveSearch();
             break;
         } else if (command == "setoption") {
-            handleSetOption(line);
+            handleSetOption(line, game);
+        } else if (command == "bench") {
+            runBench(tokens.size() > 1 ? toInt(tokens[1], DEFAULT_BENCH_DEPTH) : DEFAULT_BENCH_DEPTH);
         } else if (command == "ponderhit") {
             std::cout << "info string ponderhit not supported" << std::endl;
         } else {
@@ -0,0 +1,18 @@
+#include "evalcache.h"
+
+#include <algorithm>
+
+EvalCache::EvalCache(size_t numEntries) : entries(numEntries), mask(numEntries - 1) {
+    clear();
+}
+
+void EvalCache::clear() {
+    // an empty slot only matches keys whose upper 48 bits are zero, which is
+    // no more likely than any other collision
+    std::fill(entries.begin(), entries.end(), 0ULL);
+}
+
+EvalCache& threadEvalCache() {
+    thread_local EvalCache cache;
+    return cache;
+}
@@ -0,0 +1,52 @@
+#ifndef EVALCACHE_H
+#define EVALCACHE_H
+
+#include "types.h"
+
+#include <cstddef>
+#include <vector>
+
+// Direct-mapped cache of static evaluations keyed by the Zobrist hash.
+// Each entry packs the upper 48 key bits and the 16-bit eval into one word;
+// the lower key bits are implied by the slot index.
+
+class EvalCache {
+public:
+    static const size_t DEFAULT_ENTRIES = 1 << 16; // 512KB, power of two
+
+    explicit EvalCache(size_t numEntries = DEFAULT_ENTRIES);
+
+    inline bool probe(U64 key, int& eval) {
+        U64 entry = entries[key & mask];
+        if ((entry ^ key) & KEY_MASK) {
+            ++misses;
+            return false;
+        }
+        ++hits;
+        eval = static_cast<I16>(entry & ~KEY_MASK);
+        return true;
+    }
+
+    inline void store(U64 key, int eval) {
+        entries[key & mask] = (key & KEY_MASK) | static_cast<U16>(static_cast<I16>(eval));
+    }
+
+    void clear();
+
+    void resetStats() { hits = 0; misses = 0; }
+    long getHits() const { return hits; }
+    long getMisses() const { return misses; }
+
+private:
+    static const U64 KEY_MASK = ~0xFFFFULL;
+
+    std::vector<U64> entries;
+    size_t mask;
+    long hits = 0;
+    long misses = 0;
+};
+
+// the calling thread's cache
+EvalCache& threadEvalCache();
+
+#endif // EVALCACHE_H
@@ -1,16 +1,113 @@
 #include "evaluation.h"
+#include "pawns.h"
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <fstream>
+#include <sstream>
 
 namespace evaluation {
 
-const int INIT_TOTAL = Pwt * 16 + Nwt * 4 + Bwt * 4 + Rwt * 4 + Qwt * 2;
+#ifndef FIXED_EVAL_PARAMS
+EvalParams g_params = DEFAULT_PARAMS;
+PieceSquareTable g_psqt = buildPieceSquareTable(DEFAULT_PARAMS);
+#endif
+
+namespace {
+
+struct ParamField {
+    const char* name;
+    int* values;
+    int count;
+};
+
+// the file layout, in the order saveParams writes it
+std::vector<ParamField> paramFields(EvalParams& p) {
+    return {
+        {"pieceValueMg", p.pieceValueMg, 6},
+        {"pieceValueEg", p.pieceValueEg, 6},
+        {"pstMg", &p.pstMg[0][0], 6 * 64},
+        {"pstEg", &p.pstEg[0][0], 6 * 64},
+        {"doubledMg", &p.doubledMg, 1},
+        {"doubledEg", &p.doubledEg, 1},
+        {"isolatedMg", &p.isolatedMg, 1},
+        {"isolatedEg", &p.isolatedEg, 1},
+        {"backwardMg", &p.backwardMg, 1},
+        {"backwardEg", &p.backwardEg, 1},
+        {"passedMg", p.passedMg, 8},
+        {"passedEg", p.passedEg, 8},
+        {"shieldNear", &p.shieldNear, 1},
+        {"shieldFar", &p.shieldFar, 1},
+    };
+}
+
+} // namespace
+
+bool setParams(const EvalParams& newParams) {
+#ifdef FIXED_EVAL_PARAMS
+    (void)newParams;
+    return false;
+#else
+    g_params = newParams;
+    g_psqt = buildPieceSquareTable(newParams);
+    return true;
+#endif
+}
+
+bool loadParams(const std::string& path, EvalParams& out) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    // drop comments, then read name/values pairs from one token stream
+    std::stringstream text;
+    std::string line;
+    while (std::getline(in, line)) text << line.substr(0, line.find('#')) << '\n';
+
+    EvalParams loaded = DEFAULT_PARAMS;
+    std::vector<ParamField> fields = paramFields(loaded);
+    std::string name;
+    while (text >> name) {
+        auto field = std::find_if(fields.begin(), fields.end(),
+                                  [&](const ParamField& f) { return name == f.name; });
+        if (field == fields.end()) return false;
+        for (int i = 0; i < field->count; ++i) {
+            if (!(text >> field->values[i])) return false;
+        }
+    }
+
+    out = loaded;
+    return true;
+}
+
+bool saveParams(const std::string& path, const EvalParams& params) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    EvalParams copy = params;
+    for (const ParamField& field : paramFields(copy)) {
+        out << field.name;
+        for (int i = 0; i < field.count; ++i) {
+            // piece-square tables one rank per line
+            out << ((field.count == 6 * 64 && i % 8 == 0) ? "\n" : " ") << field.values[i];
+        }
+        out << '\n';
+    }
+    return static_cast<bool>(out);
+}
 
 int evaluateBoard(const Board& board) {
+    const pawns::PawnEntry& pawnEntry = pawns::threadTable().probe(board);
+    int mg = board.psqt.mg + pawnEntry.mg + pawns::kingShield(board);
+    int eg = board.psqt.eg + pawnEntry.eg;
+    return taperedScore(mg, eg, board.psqt.phase);
+}
+
+int evaluateBoardFull(const Board& board) {
 
     U64 pieces = board.getAllPieces();
-    
-    int score = 0;
+
+    int mg = 0;
+    int eg = 0;
 
     while (pieces) {
         int square = __builtin_ctzll(pieces);  // get the least significant set bit
@@ -19,34 +116,22 @@ int evaluateBoard(const Board& board) {
         enumPiece pieceType = board.getPieceType(square);
         enumPiece pieceColour = board.getColourType(square);
 
-        switch (pieceType) {
-            case nPawns:
-                pieceColour == nWhite ? score += wpTable[square] : score -= bpTable[square]; // Add pawn evaluation logic
-                break;
-            case nKnights:
-                pieceColour == nWhite ? score += wnTable[square] : score -= bnTable[square]; // Add knight evaluation logic
-                break;
-            case nBishops:
-                pieceColour == nWhite ? score += wbTable[square] : score -= bbTable[square]; // Add bishop evaluation logic
-                break;
-            case nRooks:
-                pieceColour == nWhite ? score += wrTable[square] : score -= brTable[square]; // Add rook evaluation logic
-                break;
-            case nQueens:
-                pieceColour == nWhite ? score += wqTable[square] : score -= bqTable[square]; // Add queen evaluation logic
-                break;
-            case nKings:
-                pieceColour == nWhite ? score += wkMidTable[square] : score -= bkMidTable[square]; // Add king evaluation logic
-                break;
-            default:
-                break;
-        }
+        int piece = pieceType - nPawns; // table order starts at pawns
+        bool white = (pieceColour == nWhite);
+        int tableSquare = pstSquare(square, white);
+        int sign = white ? 1 : -1;
+
+        const EvalParams& p = params();
+        mg += sign * (p.pieceValueMg[piece] + p.pstMg[piece][tableSquare]);
+        eg += sign * (p.pieceValueEg[piece] + p.pstEg[piece][tableSquare]);
     }
 
-    return score + materialScore(board);
+    pawns::PawnEntry pawnEntry;
+    pawns::evaluatePawns(board, pawnEntry);
+    mg += pawnEntry.mg + pawns::kingShield(board);
+    eg += pawnEntry.eg;
 
-    // int v = score + materialScore(board);
-    // return (board.gameInfo & 1) ? v : -v; // if black to move, invert scores
+    return taperedScore(mg, eg, computePhase(board));
 }
 
 int materialScore(const Board& board) {
@@ -70,57 +155,30 @@ int materialScore(const Board& board) {
 
 
 std::vector<float> piecePlanes(const Board& board) {
-    std::vector<float> output;
-    output.reserve(12 * 64); // 12 planes (6 pieces, 2 colours) for each of the 64 squares
-
-    auto push_plane = [&](U64 pieceBB) {
-        for (int sq = 0; sq < 64; ++sq) {
-            output.push_back((pieceBB & (1ULL << sq)) ? 1.0f : 0.0f);
-        }
-    };
+    std::vector<float> output(PLANE_SIZE); // 12 planes (6 pieces, 2 colours) for each of the 64 squares
+    piecePlanes(board, output.data());
+    return output;
+}
 
-    // white planes
-    push_plane(board.getWhitePawns());
-    push_plane(board.getWhiteKnights());
-    push_plane(board.getWhiteBishops());
-    push_plane(board.getWhiteRooks());
-    push_plane(board.getWhiteQueens());
-    push_plane(board.getWhiteKing());
-
-    // black planes
-    push_plane(board.getBlackPawns());
-    push_plane(board.getBlackKnights());
-    push_plane(board.getBlackBishops());
-    push_plane(board.getBlackRooks());
-    push_plane(board.getBlackQueens());
-    push_plane(board.getBlackKing());
+void piecePlanes(const Board& board, float* out) {
+    std::fill(out, out + PLANE_SIZE, 0.0f);
 
-    return output;
+    // only the occupied squares are touched, plane = getPieceIndex
+    U64 pieces = board.getAllPieces();
+    while (pieces) {
+        int square = __builtin_ctzll(pieces);
+        pieces &= pieces - 1;
+        out[board.getPieceIndex(square) * 64 + square] = 1.0f;
+    }
 }
 
-// heuristic to compute what phase the game is in, normalized [0.. 1]
-// 1 is opening, 0 is endgame
-float computePhase(const Board& board) {
-
-    int white_sum =
-        __builtin_popcountll(board.getWhitePawns()) * Pwt +
-        __builtin_popcountll(board.getWhiteKnights()) * Nwt +
-        __builtin_popcountll(board.getWhiteBishops()) * Bwt +
-        __builtin_popcountll(board.getWhiteRooks()) * Rwt +
-        __builtin_popcountll(board.getWhiteQueens()) * Qwt;
-
-    int black_sum =
-        __builtin_popcountll(board.getBlackPawns()) * Pwt +
-        __builtin_popcountll(board.getBlackKnights()) * Nwt +
-        __builtin_popcountll(board.getBlackBishops()) * Bwt +
-        __builtin_popcountll(board.getBlackRooks()) * Rwt +
-        __builtin_popcountll(board.getBlackQueens()) * Qwt;
-
-    int total = white_sum + black_sum;
-    float phase = (float)total / (float)INIT_TOTAL;
-    if (phase < 0.0f) phase = 0.0f;
-    if (phase > 1.0f) phase = 1.0f;
-    return phase;
+// game phase from the remaining non-pawn material, MAX_PHASE at the start
+// and 0 with only kings and pawns left
+int computePhase(const Board& board) {
+    return __builtin_popcountll(board.pieceBB[nKnights]) * KNIGHT_PHASE +
+           __builtin_popcountll(board.pieceBB[nBishops]) * BISHOP_PHASE +
+           __builtin_popcountll(board.pieceBB[nRooks]) * ROOK_PHASE +
+           __builtin_popcountll(board.pieceBB[nQueens]) * QUEEN_PHASE;
 }
 
 
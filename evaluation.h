@@ -3,8 +3,10 @@
 
 #include "board.h"
 #include "game.h"
+#include "pawns.h"
 #include "types.h"
 
+#include <string>
 #include <vector>
 
 // values taken from https://www.chessprogramming.org/Simplified_Evaluation_Function
@@ -22,11 +24,40 @@ const int Rwt = 500;
 const int Qwt = 900;
 // const int Kwt = 20000;
 
+// endgame piece values, pawns and rooks gain relative to the minors
+const int PwtEg = 120;
+const int NwtEg = 300;
+const int BwtEg = 320;
+const int RwtEg = 540;
+const int QwtEg = 950;
+
+// game phase: 24 with all minors/rooks/queens on the board, 0 with none
+const int KNIGHT_PHASE = 1;
+const int BISHOP_PHASE = 1;
+const int ROOK_PHASE = 2;
+const int QUEEN_PHASE = 4;
+const int MAX_PHASE = 4 * KNIGHT_PHASE + 4 * BISHOP_PHASE + 4 * ROOK_PHASE + 2 * QUEEN_PHASE;
+
+// blends the incrementally maintained board.psqt and the cached pawn-structure
+// terms (pawns.h) by phase (white perspective)
 int evaluateBoard(const Board& board);
+// full recompute of the same terms without any caches, used to verify evaluateBoard
+int evaluateBoardFull(const Board& board);
 int materialScore(const Board& board);
+int computePhase(const Board& board);
+
+// interpolates between middlegame and endgame by phase
+inline int taperedScore(int mg, int eg, int phase) {
+    if (phase > MAX_PHASE) phase = MAX_PHASE; // early promotions can push it past the start value
+    return (mg * phase + eg * (MAX_PHASE - phase)) / MAX_PHASE;
+}
 
 // plane / feature extractors
-// std::vector<float> piecePlanes(const Board& board);
+// 12 planes of 64 squares, white P N B R Q K then black (= getPieceIndex order)
+const int PLANE_SIZE = 12 * 64;
+std::vector<float> piecePlanes(const Board& board);
+// writes PLANE_SIZE floats into out, for contiguous batch buffers
+void piecePlanes(const Board& board, float* out);
 
 
 inline int pieceScore(const enumPiece& pieceType){
@@ -41,6 +72,254 @@ inline int pieceScore(const enumPiece& pieceType){
     }
 }
 
+// Piece-square tables, written from white's point of view as seen on a
+// diagram (first row is rank 8). White reads square ^ 56, black reads the
+// square directly, which mirrors the table vertically.
+// order: pawn, knight, bishop, rook, queen, king
+
+constexpr int pstMg[6][64] = {
+    { // pawn
+      0,  0,  0,  0,  0,  0,  0,  0,
+     50, 50, 50, 50, 50, 50, 50, 50,
+     10, 10, 20, 30, 30, 20, 10, 10,
+      5,  5, 10, 25, 25, 10,  5,  5,
+      0,  0,  0, 20, 20,  0,  0,  0,
+      5, -5,-10,  0,  0,-10, -5,  5,
+      5, 10, 10,-20,-20, 10, 10,  5,
+      0,  0,  0,  0,  0,  0,  0,  0 },
+    { // knight
+    -50,-40,-30,-30,-30,-30,-40,-50,
+    -40,-20,  0,  0,  0,  0,-20,-40,
+    -30,  0, 10, 15, 15, 10,  0,-30,
+    -30,  5, 15, 20, 20, 15,  5,-30,
+    -30,  0, 15, 20, 20, 15,  0,-30,
+    -30,  5, 10, 15, 15, 10,  5,-30,
+    -40,-20,  0,  5,  5,  0,-20,-40,
+    -50,-40,-30,-30,-30,-30,-40,-50 },
+    { // bishop
+    -20,-10,-10,-10,-10,-10,-10,-20,
+    -10,  0,  0,  0,  0,  0,  0,-10,
+    -10,  0,  5, 10, 10,  5,  0,-10,
+    -10,  5,  5, 10, 10,  5,  5,-10,
+    -10,  0, 10, 10, 10, 10,  0,-10,
+    -10, 10, 10, 10, 10, 10, 10,-10,
+    -10,  5,  0,  0,  0,  0,  5,-10,
+    -20,-10,-10,-10,-10,-10,-10,-20 },
+    { // rook
+      0,  0,  0,  0,  0,  0,  0,  0,
+      5, 10, 10, 10, 10, 10, 10,  5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+      0,  0,  0,  5,  5,  0,  0,  0 },
+    { // queen
+    -20,-10,-10, -5, -5,-10,-10,-20,
+    -10,  0,  0,  0,  0,  0,  0,-10,
+    -10,  0,  5,  5,  5,  5,  0,-10,
+     -5,  0,  5,  5,  5,  5,  0, -5,
+      0,  0,  5,  5,  5,  5,  0, -5,
+    -10,  5,  5,  5,  5,  5,  0,-10,
+    -10,  0,  5,  0,  0,  0,  0,-10,
+    -20,-10,-10, -5, -5,-10,-10,-20 },
+    { // king: stay sheltered behind the pawns
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -20,-30,-30,-40,-40,-30,-30,-20,
+    -10,-20,-20,-20,-20,-20,-20,-10,
+     20, 20,  0,  0,  0,  0, 20, 20,
+     20, 30, 10,  0,  0, 10, 30, 20 },
+};
+
+constexpr int pstEg[6][64] = {
+    { // pawn: advancement is what matters once the pieces are gone
+      0,  0,  0,  0,  0,  0,  0,  0,
+     80, 80, 80, 80, 80, 80, 80, 80,
+     50, 50, 50, 50, 50, 50, 50, 50,
+     30, 30, 30, 30, 30, 30, 30, 30,
+     15, 15, 15, 15, 15, 15, 15, 15,
+      5,  5,  5,  5,  5,  5,  5,  5,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0 },
+    { // knight
+    -50,-40,-30,-30,-30,-30,-40,-50,
+    -40,-20,  0,  0,  0,  0,-20,-40,
+    -30,  0, 10, 15, 15, 10,  0,-30,
+    -30,  5, 15, 20, 20, 15,  5,-30,
+    -30,  0, 15, 20, 20, 15,  0,-30,
+    -30,  5, 10, 15, 15, 10,  5,-30,
+    -40,-20,  0,  5,  5,  0,-20,-40,
+    -50,-40,-30,-30,-30,-30,-40,-50 },
+    { // bishop
+    -15,-10,-10,-10,-10,-10,-10,-15,
+    -10,  0,  0,  0,  0,  0,  0,-10,
+    -10,  0,  5,  5,  5,  5,  0,-10,
+    -10,  0,  5, 10, 10,  5,  0,-10,
+    -10,  0,  5, 10, 10,  5,  0,-10,
+    -10,  0,  5,  5,  5,  5,  0,-10,
+    -10,  0,  0,  0,  0,  0,  0,-10,
+    -15,-10,-10,-10,-10,-10,-10,-15 },
+    { // rook
+      5,  5,  5,  5,  5,  5,  5,  5,
+     10, 10, 10, 10, 10, 10, 10, 10,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0 },
+    { // queen
+    -20,-10,-10, -5, -5,-10,-10,-20,
+    -10,  0,  5,  5,  5,  5,  0,-10,
+    -10,  5, 10, 10, 10, 10,  5,-10,
+     -5,  5, 10, 15, 15, 10,  5, -5,
+     -5,  5, 10, 15, 15, 10,  5, -5,
+    -10,  5, 10, 10, 10, 10,  5,-10,
+    -10,  0,  5,  5,  5,  5,  0,-10,
+    -20,-10,-10, -5, -5,-10,-10,-20 },
+    { // king: centralise and support the pawns
+    -50,-40,-30,-20,-20,-30,-40,-50,
+    -30,-20,-10,  0,  0,-10,-20,-30,
+    -30,-10, 20, 30, 30, 20,-10,-30,
+    -30,-10, 30, 40, 40, 30,-10,-30,
+    -30,-10, 30, 40, 40, 30,-10,-30,
+    -30,-10, 20, 30, 30, 20,-10,-30,
+    -30,-30,  0,  0,  0,  0,-30,-30,
+    -50,-30,-30,-30,-30,-30,-30,-50 },
+};
+
+constexpr int pieceValueMg[6] = {Pwt, Nwt, Bwt, Rwt, Qwt, 0};
+constexpr int pieceValueEg[6] = {PwtEg, NwtEg, BwtEg, RwtEg, QwtEg, 0};
+constexpr int piecePhase[6] = {0, KNIGHT_PHASE, BISHOP_PHASE, ROOK_PHASE, QUEEN_PHASE, 0};
+
+// table square for a piece of the given colour (see layout note above)
+constexpr int pstSquare(int square, bool white) {
+    return white ? (square ^ 56) : square;
+}
+
+// every evaluation weight in one flat block, so a parameter file can replace
+// them at runtime (piece values, piece-square tables, pawns.h terms)
+struct EvalParams {
+    int pieceValueMg[6];
+    int pieceValueEg[6];
+    int pstMg[6][64];
+    int pstEg[6][64];
+    int doubledMg, doubledEg;
+    int isolatedMg, isolatedEg;
+    int backwardMg, backwardEg;
+    int passedMg[8];
+    int passedEg[8];
+    int shieldNear, shieldFar;
+};
+
+constexpr EvalParams buildDefaultParams() {
+    EvalParams params{};
+    for (int piece = 0; piece < 6; ++piece) {
+        params.pieceValueMg[piece] = pieceValueMg[piece];
+        params.pieceValueEg[piece] = pieceValueEg[piece];
+        for (int square = 0; square < 64; ++square) {
+            params.pstMg[piece][square] = pstMg[piece][square];
+            params.pstEg[piece][square] = pstEg[piece][square];
+        }
+    }
+    params.doubledMg = pawns::DOUBLED_MG;
+    params.doubledEg = pawns::DOUBLED_EG;
+    params.isolatedMg = pawns::ISOLATED_MG;
+    params.isolatedEg = pawns::ISOLATED_EG;
+    params.backwardMg = pawns::BACKWARD_MG;
+    params.backwardEg = pawns::BACKWARD_EG;
+    for (int rank = 0; rank < 8; ++rank) {
+        params.passedMg[rank] = pawns::PASSED_MG[rank];
+        params.passedEg[rank] = pawns::PASSED_EG[rank];
+    }
+    params.shieldNear = pawns::SHIELD_NEAR;
+    params.shieldFar = pawns::SHIELD_FAR;
+    return params;
+}
+
+} // namespace evaluation
+
+// make TUNED_EVAL_PARAMS=1 takes the default weights from the tuner's
+// tuned_params.h instead of the constants above
+#ifdef TUNED_EVAL_PARAMS
+#include "tuned_params.h"
+#endif
+
+namespace evaluation {
+
+#ifdef TUNED_EVAL_PARAMS
+inline constexpr EvalParams DEFAULT_PARAMS = TUNED_PARAMS;
+#else
+inline constexpr EvalParams DEFAULT_PARAMS = buildDefaultParams();
+#endif
+
+// material + piece-square values and phase weight for each zobrist piece index
+// (0-5 white, 6-11 black) and square, signed from white's point of view so they
+// can be summed incrementally
+struct PieceSquareTable {
+    PsqtScore values[12][64];
+};
+
+constexpr PieceSquareTable buildPieceSquareTable(const EvalParams& params) {
+    PieceSquareTable table{};
+    for (int square = 0; square < 64; ++square) {
+        for (int piece = 0; piece < 6; ++piece) {
+            int w = pstSquare(square, true);
+            int b = pstSquare(square, false);
+            table.values[piece][square].mg = params.pieceValueMg[piece] + params.pstMg[piece][w];
+            table.values[piece][square].eg = params.pieceValueEg[piece] + params.pstEg[piece][w];
+            table.values[piece][square].phase = piecePhase[piece];
+            table.values[piece + 6][square].mg = -(params.pieceValueMg[piece] + params.pstMg[piece][b]);
+            table.values[piece + 6][square].eg = -(params.pieceValueEg[piece] + params.pstEg[piece][b]);
+            table.values[piece + 6][square].phase = piecePhase[piece];
+        }
+    }
+    return table;
+}
+
+// Production builds (make FIXED_EVAL_PARAMS=1) bake the defaults in as
+// constants; otherwise the weights live in globals that setParams() replaces.
+#ifdef FIXED_EVAL_PARAMS
+const bool PARAMS_LOADABLE = false;
+
+inline constexpr PieceSquareTable PSQT = buildPieceSquareTable(DEFAULT_PARAMS);
+
+constexpr const EvalParams& params() {
+    return DEFAULT_PARAMS;
+}
+
+inline const PsqtScore& psqtValue(int pieceIndex, int square) {
+    return PSQT.values[pieceIndex][square];
+}
+#else
+const bool PARAMS_LOADABLE = true;
+
+extern EvalParams g_params;
+extern PieceSquareTable g_psqt;
+
+inline const EvalParams& params() {
+    return g_params;
+}
+
+inline const PsqtScore& psqtValue(int pieceIndex, int square) {
+    return g_psqt.values[pieceIndex][square];
+}
+#endif
+
+// Installs new weights (false in FIXED_EVAL_PARAMS builds). Boards built
+// before the call keep their old psqt sums, and pawn tables, eval caches and
+// TT static evals hold old scores, so callers reset those.
+bool setParams(const EvalParams& newParams);
+
+// Text format: a field name followed by its values, e.g. `doubledMg -10` or
+// `pstMg` and 384 numbers; '#' starts a comment. Fields the file leaves out
+// keep their DEFAULT_PARAMS values.
+bool loadParams(const std::string& path, EvalParams& out);
+bool saveParams(const std::string& path, const EvalParams& params);
+
 }
 
 
@@ -1,5 +1,9 @@
 #include "game.h"
 #include "bitboard.h"
+#include "evaluation.h"
+
+#include <algorithm>
+#include <cstring>
 
 using namespace std;
 
@@ -8,6 +12,8 @@ void Game::enableFastMode() {
     searchHistory[0].move = MOVE_NONE;                // empty/dummy move
     searchHistory[0].gameInfo = board.gameInfo;
     searchHistory[0].hash = board.getHash();
+    searchHistory[0].pawnHash = board.pawnHash;
+    searchHistory[0].psqt = board.psqt;
     searchHistory[0].pieceMoved = nEmpty;          // dummy piece for empty move
     searchDepth = 1;
 }
@@ -249,7 +255,7 @@ GameState Game::checkForMateOrStaleMate() {
 
 bool Game::isFiftyMoveRule() const {
     // Check if the halfmove clock is 100 or more
-    return ((board.gameInfo & MOVE_MASK) >> 6) >= 100;
+    return board.getHalfMoveClock() >= 100;
 }
 
 bool Game::isThreefoldRepetition() const {
@@ -686,6 +692,18 @@ void Game::generatePawnMovesForSquare(int square, MovesStruct& legalMoves, int k
             movesBB |= (1ULL << epSquare);
         if (board.friendlyColour() == nBlack && row == 3 && abs(col - epCol) == 1 && epRow == 2)
             movesBB |= (1ULL << epSquare);
+
+        // en passant empties two squares of the king's rank at once, which the
+        // pin masks cannot see: look for a rook or queen behind both pawns
+        if ((movesBB & (1ULL << epSquare)) && kingSquare / 8 == row) {
+            int capturedSquare = row * 8 + epCol;
+            U64 occupied = (board.getAllPieces() & ~(1ULL << square) & ~(1ULL << capturedSquare)) | (1ULL << epSquare);
+            U64 enemyRooksQueens = (board.enemyColour() == nWhite) ?
+                (board.getWhiteRooks() | board.getWhiteQueens()) :
+                (board.getBlackRooks() | board.getBlackQueens());
+            if (getRookAttacks(occupied, kingSquare) & enemyRooksQueens)
+                movesBB &= ~(1ULL << epSquare);
+        }
     }
 
     // return early to only check for captures
@@ -808,6 +826,12 @@ void Game::addMovesToStructInCheck(enumPiece pieceType, MovesStruct& moves, int
                 legalSquares |= blockingSquares;
             }
         }
+
+        // a checking pawn that just double pushed can also be taken en passant
+        int epSquare = board.getEnPassantSquare();
+        if (pieceType == nPawns && checkerPiece == nPawns && epSquare != -1 && epSquare % 8 == checkerSquare % 8) {
+            legalSquares |= (1ULL << epSquare);
+        }
         
         // filer moves to only legal squares
         movesBB &= legalSquares;
@@ -899,6 +923,8 @@ void Game::pushMove(Move move) {
         searchHistory[searchDepth].move = move;
         searchHistory[searchDepth].gameInfo = board.gameInfo;
         searchHistory[searchDepth].hash = board.hash;
+        searchHistory[searchDepth].pawnHash = board.pawnHash;
+        searchHistory[searchDepth].psqt = board.psqt;
         searchHistory[searchDepth].pieceMoved = piece; // Store piece type for efficient unmake
         
         searchDepth++;
@@ -909,6 +935,8 @@ void Game::pushMove(Move move) {
         currentState.move = move;
         currentState.gameInfo = board.gameInfo;
         currentState.hash = board.hash;
+        currentState.pawnHash = board.pawnHash;
+        currentState.psqt = board.psqt;
         currentState.pieceMoved = piece; // Store piece type for efficient unmake
         pushBoardState(currentState);
     }
@@ -965,49 +993,68 @@ void Game::pushMove(Move move) {
     if (isCapture(move) || piece == nPawns){
        board.gameInfo &= ~MOVE_MASK; // reset halfmove clock
     } else {
-        board.gameInfo = (board.gameInfo & ~MOVE_MASK) | (((((board.gameInfo & MOVE_MASK) >> 6) + 1) << 6) & MOVE_MASK);
+        int halfmoveClock = std::min(board.getHalfMoveClock() + 1, MAX_HALFMOVE_CLOCK);
+        board.gameInfo = (board.gameInfo & ~MOVE_MASK) | (halfmoveClock << MOVE_SHIFT);
     }
 
     board.updateCasltingRights(piece, colour, from); // update castling rights
 
     board.gameInfo ^= TURN_MASK;
+    if (colour == nBlack) ++board.fullmoveNumber;
 
     // get new state for hash calculation
     int newCastlingIdx = board.getCastlingIndex();
     int newEpFile = (board.gameInfo & EP_IS_SET) ? ((board.gameInfo & EP_FILE_MASK) >> EP_FILE_SHIFT) : -1;
 
      // ONE SINGLE HASH UPDATE with all changes
-    board.hash ^= tables.zobristTable[board.getPieceIndex(piece, colour)][from];           // Remove old piece
-    board.hash ^= tables.zobristTable[board.getPieceIndex(finalPiece, colour)][to];       // Add new piece
+     // (the incremental eval terms take the same piece deltas)
+    const int movedIndex = board.getPieceIndex(piece, colour);
+    const int finalIndex = board.getPieceIndex(finalPiece, colour);
+    nnue::FeatureDelta delta;
+    delta.remove(movedIndex, from);
+    delta.add(finalIndex, to);
+    board.hash ^= tables.zobristTable[movedIndex][from];           // Remove old piece
+    board.hash ^= tables.zobristTable[finalIndex][to];       // Add new piece
+    board.psqt += evaluation::psqtValue(finalIndex, to) - evaluation::psqtValue(movedIndex, from);
+    if (piece == nPawns) board.pawnHash ^= tables.zobristTable[movedIndex][from];
+    if (finalPiece == nPawns) board.pawnHash ^= tables.zobristTable[finalIndex][to];
 
     // captures
     if (isCapture(move)) {
         if (isEPCapture(move)) {
             int capturePawnSquare = (colour == nWhite) ? to - 8 : to + 8;
-            board.hash ^= tables.zobristTable[board.getPieceIndex(nPawns, capturedColour)][capturePawnSquare];
+            const int capturedIndex = board.getPieceIndex(nPawns, capturedColour);
+            board.hash ^= tables.zobristTable[capturedIndex][capturePawnSquare];
+            board.psqt -= evaluation::psqtValue(capturedIndex, capturePawnSquare);
+            board.pawnHash ^= tables.zobristTable[capturedIndex][capturePawnSquare];
+            delta.remove(capturedIndex, capturePawnSquare);
         } else {
-            board.hash ^= tables.zobristTable[board.getPieceIndex(capturedPiece, capturedColour)][to];
+            const int capturedIndex = board.getPieceIndex(capturedPiece, capturedColour);
+            board.hash ^= tables.zobristTable[capturedIndex][to];
+            board.psqt -= evaluation::psqtValue(capturedIndex, to);
+            if (capturedPiece == nPawns) board.pawnHash ^= tables.zobristTable[capturedIndex][to];
+            delta.remove(capturedIndex, to);
         }
     }
 
     // castling rook hash updates
-    if (moveType == KING_CASTLE) {
-        if (colour == nWhite) {
-            board.hash ^= tables.zobristTable[board.getPieceIndex(nRooks, nWhite)][7];
-            board.hash ^= tables.zobristTable[board.getPieceIndex(nRooks, nWhite)][5];
-        } else {
-            board.hash ^= tables.zobristTable[board.getPieceIndex(nRooks, nBlack)][63];
-            board.hash ^= tables.zobristTable[board.getPieceIndex(nRooks, nBlack)][61];
-        }
-    } else if (moveType == QUEEN_CASTLE) {
-        if (colour == nWhite) {
-            board.hash ^= tables.zobristTable[board.getPieceIndex(nRooks, nWhite)][0];
-            board.hash ^= tables.zobristTable[board.getPieceIndex(nRooks, nWhite)][3];
+    if (moveType == KING_CASTLE || moveType == QUEEN_CASTLE) {
+        const int rookIndex = board.getPieceIndex(nRooks, colour);
+        int rookFrom, rookTo;
+        if (moveType == KING_CASTLE) {
+            rookFrom = (colour == nWhite) ? 7 : 63;
+            rookTo = (colour == nWhite) ? 5 : 61;
         } else {
-            board.hash ^= tables.zobristTable[board.getPieceIndex(nRooks, nBlack)][56];
-            board.hash ^= tables.zobristTable[board.getPieceIndex(nRooks, nBlack)][59];
+            rookFrom = (colour == nWhite) ? 0 : 56;
+            rookTo = (colour == nWhite) ? 3 : 59;
         }
+        board.hash ^= tables.zobristTable[rookIndex][rookFrom];
+        board.hash ^= tables.zobristTable[rookIndex][rookTo];
+        board.psqt += evaluation::psqtValue(rookIndex, rookTo) - evaluation::psqtValue(rookIndex, rookFrom);
+        delta.remove(rookIndex, rookFrom);
+        delta.add(rookIndex, rookTo);
     }
+    accumulators.push(delta);
 
     // Update castling hash
     board.hash ^= tables.zobristCastling[oldCastlingIdx];
@@ -1029,6 +1076,168 @@ void Game::pushMove(Move move) {
 
 
 
+void Game::pushNullMove() {
+    cachedPinnedPieces = 0ULL;
+    memset(cachedPinnedMasks, 0ULL, sizeof(cachedPinnedMasks));
+
+    BoardState currentState;
+    currentState.move = MOVE_NONE;
+    currentState.gameInfo = board.gameInfo;
+    currentState.hash = board.hash;
+    currentState.pawnHash = board.pawnHash;
+    currentState.psqt = board.psqt;
+    currentState.pieceMoved = nEmpty;
+    if (useStackHistory) {
+        searchHistory[searchDepth++] = currentState;
+    } else {
+        pushBoardState(currentState);
+    }
+
+    if (board.gameInfo & EP_IS_SET) {
+        board.hash ^= tables.zobristEnPassant[(board.gameInfo & EP_FILE_MASK) >> EP_FILE_SHIFT];
+    }
+    board.clearEpSquare();
+    board.gameInfo &= ~MOVE_MASK;
+
+    if (board.friendlyColour() == nBlack) ++board.fullmoveNumber;
+    board.gameInfo ^= TURN_MASK;
+    board.hash ^= tables.zobristSideToMove;
+
+    accumulators.push(nnue::FeatureDelta());
+    invalidateGameState();
+}
+
+void Game::popNullMove() {
+    popMove(); // a MOVE_NONE entry only restores the saved state
+}
+
+U64 Game::attackersTo(int square, U64 occupancy) {
+    const U64 bishopsQueens = board.pieceBB[nBishops] | board.pieceBB[nQueens];
+    const U64 rooksQueens = board.pieceBB[nRooks] | board.pieceBB[nQueens];
+    return (tables.pawnMovesCapturesBB[nBlack][square] & board.getWhitePawns()) |
+           (tables.pawnMovesCapturesBB[nWhite][square] & board.getBlackPawns()) |
+           (tables.knightBB[square] & board.pieceBB[nKnights]) |
+           (tables.kingBB[square] & board.pieceBB[nKings]) |
+           (getBishopAttacks(occupancy, square) & bishopsQueens) |
+           (getRookAttacks(occupancy, square) & rooksQueens);
+}
+
+namespace {
+
+const int SEE_KING_VALUE = 20000;
+
+int seeValue(enumPiece piece) {
+    return piece == nKings ? SEE_KING_VALUE : evaluation::pieceScore(piece);
+}
+
+int seeCapturedValue(Move move) {
+    const enumPiece captured = getCapturedPiece(move);
+    return captured == nEmpty ? 0 : seeValue(captured);
+}
+
+} // namespace
+
+int Game::see(Move move) {
+    if (isCastle(move)) return 0;
+
+    const int from = getFrom(move);
+    const int to = getTo(move);
+    const bool promotion = isPromotion(move) || isPromoCapture(move);
+    enumPiece attacker = promotion ? getPromotionPiece(move) : board.getPieceType(from);
+
+    int gain[32];
+    int d = 0;
+    gain[0] = seeCapturedValue(move);
+    if (promotion) gain[0] += seeValue(attacker) - seeValue(nPawns);
+
+    U64 occupied = board.getAllPieces() ^ (1ULL << from);
+    if (isEPCapture(move)) occupied ^= 1ULL << (board.friendlyColour() == nWhite ? to - 8 : to + 8);
+    U64 attackers = attackersTo(to, occupied) & occupied;
+    const U64 bishopsQueens = board.pieceBB[nBishops] | board.pieceBB[nQueens];
+    const U64 rooksQueens = board.pieceBB[nRooks] | board.pieceBB[nQueens];
+    U8 side = board.enemyColour();
+
+    // gain[d]: balance for the side making capture d if nothing recaptures
+    while (d < 31) {
+        U64 sideAttackers = attackers & board.pieceBB[side];
+        if (!sideAttackers) break;
+
+        enumPiece next = nPawns;
+        while (!(sideAttackers & board.pieceBB[next])) next = static_cast<enumPiece>(next + 1);
+        // the king only recaptures onto an undefended square
+        if (next == nKings && (attackers & board.pieceBB[side == nWhite ? nBlack : nWhite])) break;
+
+        ++d;
+        gain[d] = seeValue(attacker) - gain[d - 1];
+
+        occupied ^= sideAttackers & board.pieceBB[next] & -(sideAttackers & board.pieceBB[next]);
+        if (next == nPawns || next == nBishops || next == nQueens) attackers |= getBishopAttacks(occupied, to) & bishopsQueens;
+        if (next == nRooks || next == nQueens) attackers |= getRookAttacks(occupied, to) & rooksQueens;
+        attackers &= occupied;
+
+        attacker = next;
+        side = (side == nWhite) ? nBlack : nWhite;
+    }
+
+    // each side may stop capturing whenever carrying on is worse
+    for (; d > 0; --d) gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+    return gain[0];
+}
+
+bool Game::seeGE(Move move, int threshold) {
+    if (isCastle(move)) return 0 >= threshold;
+
+    const int from = getFrom(move);
+    const int to = getTo(move);
+    const bool promotion = isPromotion(move) || isPromoCapture(move);
+    const enumPiece mover = promotion ? getPromotionPiece(move) : board.getPieceType(from);
+
+    // swap: what the side to move is up against in each step
+    int swap = seeCapturedValue(move) - threshold;
+    if (promotion) swap += seeValue(mover) - seeValue(nPawns);
+    if (swap < 0) return false; // even an unanswered capture is not enough
+
+    swap = seeValue(mover) - swap;
+    if (swap <= 0) return true; // losing the mover still clears the threshold
+
+    U64 occupied = board.getAllPieces() ^ (1ULL << from);
+    if (isEPCapture(move)) occupied ^= 1ULL << (board.friendlyColour() == nWhite ? to - 8 : to + 8);
+    U64 attackers = attackersTo(to, occupied) & occupied;
+    const U64 bishopsQueens = board.pieceBB[nBishops] | board.pieceBB[nQueens];
+    const U64 rooksQueens = board.pieceBB[nRooks] | board.pieceBB[nQueens];
+    U8 side = board.friendlyColour();
+    bool result = true;
+
+    while (true) {
+        side = (side == nWhite) ? nBlack : nWhite;
+        attackers &= occupied;
+        U64 sideAttackers = attackers & board.pieceBB[side];
+        if (!sideAttackers) break;
+
+        result = !result;
+
+        enumPiece next = nPawns;
+        while (!(sideAttackers & board.pieceBB[next])) next = static_cast<enumPiece>(next + 1);
+        if (next == nKings) {
+            // a king recapture stands only if nothing can take it back
+            return (attackers & board.pieceBB[side == nWhite ? nBlack : nWhite]) ? !result : result;
+        }
+
+        swap = seeValue(next) - swap;
+        if (swap < static_cast<int>(result)) break;
+
+        occupied ^= sideAttackers & board.pieceBB[next] & -(sideAttackers & board.pieceBB[next]);
+        if (next == nPawns || next == nBishops || next == nQueens) attackers |= getBishopAttacks(occupied, to) & bishopsQueens;
+        if (next == nRooks || next == nQueens) attackers |= getRookAttacks(occupied, to) & rooksQueens;
+    }
+    return result;
+}
+
+Move Game::lastMove() const {
+    if (useStackHistory) return searchHistory[searchDepth - 1].move;
+    return historyTail ? historyTail->state.move : MOVE_NONE;
+}
+
 void Game::popMove() {
 
     BoardState prevState;
@@ -1056,7 +1265,11 @@ void Game::popMove() {
     }
 
     board.gameInfo = prevState.gameInfo;
+    if (!(board.gameInfo & TURN_MASK)) --board.fullmoveNumber; // undoing a black move
     board.hash = prevState.hash; // restore the hash from the previous state
+    board.pawnHash = prevState.pawnHash;
+    accumulators.pop();
+    board.psqt = prevState.psqt;
     Move move = prevState.move;
     enumPiece pieceMoved = prevState.pieceMoved; // Use stored piece type (original piece)
 
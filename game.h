@@ -5,6 +5,7 @@
 #include "types.h"
 #include "movetables.h"
 #include "move.h"
+#include "nnue.h"
 
 #include <iostream>
 #include <cstdint>
@@ -20,6 +21,8 @@ using namespace std;
 
 struct BoardState {
     U64 hash;
+    U64 pawnHash;
+    PsqtScore psqt;
     U16 gameInfo;
     Move move;
     enumPiece pieceMoved = nEmpty;  // Piece that was moved (for efficient unmake) - default to nEmpty
@@ -72,17 +75,43 @@ public:
     void reset(){
         board = Board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"); // Reset to initial state
         clearHistory();
+        accumulators.reset();
+        invalidateGameState();
     }
 
     void setPosition(const std::string& fen) {
         board = Board(fen);
         clearHistory();
+        accumulators.reset();
+        invalidateGameState();
+    }
+
+    void setPosition(const Board& position) {
+        board = position;
+        clearHistory();
+        accumulators.reset();
         invalidateGameState();
     }
 
     void pushMove(Move move);
     void popMove();
 
+    // null move for null-move pruning: passes the turn, clears en passant and
+    // is recorded in the history like a move (as MOVE_NONE). It also resets the
+    // halfmove clock, so repetition checks never look past it
+    void pushNullMove();
+    void popNullMove();
+    // most recent history entry: MOVE_NONE after a null move or with no history
+    Move lastMove() const;
+
+    // static exchange evaluation of a move on its target square: material
+    // balance in centipawns (evaluation::pieceScore values) once both sides
+    // have made every profitable capture there, least valuable attacker
+    // first. Sliders behind a capturing piece join in (x-rays); pins are
+    // ignored. seeGE answers see(move) >= threshold with early exits
+    int see(Move move);
+    bool seeGE(Move move, int threshold);
+
     void enableFastMode();
     void disableFastMode();
 
@@ -119,6 +148,13 @@ public:
     bool isDrawByRule();
     void invalidateGameState();
 
+    // network accumulator for the current position (refreshed lazily by nnue::evaluate)
+    nnue::Accumulator& currentAccumulator() const { return accumulators.current(); }
+    // computes the current accumulator if needed so later pushes are incremental
+    void refreshAccumulator() const { accumulators.refresh(board); }
+    // after a network load or toggle: the stored values belong to the old one
+    void invalidateAccumulators() const { accumulators.invalidate(); }
+
 
 private:
     const MoveTables& tables; // reference to move tables
@@ -142,6 +178,9 @@ private:
     HistoryNode* historyHead; // pointer to the head of the history linked list
     HistoryNode* historyTail; // pointer to the tail of the history linked list
 
+    // one accumulator per pushed move, mirrors the board history
+    mutable nnue::AccumulatorStack accumulators;
+
     U64 cachedPinnedPieces = 0ULL;
     U64 cachedPinnedMasks[64] = {0ULL};
 
@@ -156,6 +195,8 @@ private:
 
     U64 getBishopAttacks(U64 occupancy, int square);
     U64 getRookAttacks(U64 occupancy, int square);
+    // pieces of both colours attacking square through the given occupancy
+    U64 attackersTo(int square, U64 occupancy);
     U64 getPinnedPieces(U8 colour);
     U64 getPinnedMask(int square, U8 colour);
 
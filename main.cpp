@@ -1,10 +1,29 @@
+#include "batch.h"
+#include "bitboard.h"
 #include "board.h"
+#include "evalcache.h"
+#include "evaluation.h"
 #include "game.h"
 #include "move.h"
+#include "nnue.h"
+#include "nnue_simd.h"
+#include "pawns.h"
+#include "search.h"
+#include "selfplay.h"
+#include "texel.h"
+#include "transposition.h"
 
 
 #include <iostream>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <vector>
 
 
 void test_checkmate() {
@@ -56,6 +75,22 @@ void test_en_passant_illegality() {
     for (int i = 0; i < legalMoves.getNumMoves(); ++i){
         assert(!isEPCapture(legalMoves.getMove(i)) && "En passant should NOT be legal");
     }
+
+    // capturing en passant would clear the rank between the rook and the king
+    Game rankPin("8/2p5/3p4/KP5r/1R2Pp1k/8/6P1/8 b - e3 0 1");
+    legalMoves = rankPin.generateAllLegalMoves();
+    for (int i = 0; i < legalMoves.getNumMoves(); ++i) {
+        assert(!isEPCapture(legalMoves.getMove(i)) && "En passant should not expose the king along the rank");
+    }
+
+    // ...but it does remove a pawn that gives check
+    Game pawnCheck("8/8/8/1PpP4/RK3p1k/8/4P3/8 w - c6 0 1");
+    legalMoves = pawnCheck.generateAllLegalMoves();
+    int epCaptures = 0;
+    for (int i = 0; i < legalMoves.getNumMoves(); ++i) {
+        if (isEPCapture(legalMoves.getMove(i))) epCaptures++;
+    }
+    assert(epCaptures == 2 && "En passant should capture a checking pawn");
 }
 
 void test_castling_rights() {
@@ -111,6 +146,838 @@ void test_king_cannot_move_into_check() {
     }
 }
 
+void test_slider_tables() {
+    // exhaustive: every relevant occupancy on every square, for each lookup backend
+    MagicBitboard& magic = MagicBitboard::instance();
+    assert(magic.validateTables(SliderBackend::Magic) && "Magic slider tables should match ray walking");
+    if (MagicBitboard::cpuSupportsPext()) {
+        assert(magic.validateTables(SliderBackend::Pext) && "PEXT slider tables should match ray walking");
+    }
+}
+
+void test_start_position_hash() {
+    // generated Zobrist keys must agree between incremental updates and a full recompute
+    Game game;
+    MovesStruct legalMoves = game.generateAllLegalMoves();
+    for (int i = 0; i < legalMoves.getNumMoves(); ++i) {
+        game.pushMove(legalMoves.getMove(i));
+        U64 incremental = game.board.getHash();
+        game.board.calculateHash();
+        assert(incremental == game.board.getHash() && "Incremental hash should match full recompute");
+        game.popMove();
+    }
+}
+
+void test_null_move() {
+    // passing flips the side and drops en passant; the incremental hash must
+    // match a recompute and popping must restore everything, in both history modes
+    for (bool fastMode : {false, true}) {
+        Game game("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3");
+        if (fastMode) game.enableFastMode();
+        const std::string fen = game.board.toString();
+        const U64 hash = game.board.getHash();
+
+        game.pushNullMove();
+        assert(game.board.friendlyColour() == nBlack && game.board.getEnPassantSquare() == -1 && "Null move should pass the turn and clear en passant");
+        assert(game.lastMove() == MOVE_NONE && "Null move should be recorded as MOVE_NONE");
+        U64 incremental = game.board.getHash();
+        game.board.calculateHash();
+        assert(incremental == game.board.getHash() && "Null move hash should match full recompute");
+
+        game.popNullMove();
+        assert(game.board.toString() == fen && game.board.getHash() == hash && "popNullMove should restore the position");
+    }
+
+    // repetition checks stop at a null move
+    Game game("4k3/8/8/8/8/8/8/4K2R w - - 10 40");
+    game.enableFastMode();
+    game.pushNullMove();
+    game.pushNullMove();
+    assert(!game.isThreefoldRepetition() && "Positions across a null move are not repetitions");
+}
+
+void test_static_exchange() {
+    auto see = [](const std::string& fen, const std::string& uci) {
+        Game game(fen);
+        MovesStruct moves = game.generateAllLegalMoves();
+        for (int i = 0; i < moves.getNumMoves(); ++i) {
+            if (moveToString(moves.getMove(i)) == uci) return game.see(moves.getMove(i));
+        }
+        assert(false && "SEE test move should be legal");
+        return 0;
+    };
+
+    assert(see("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1", "e1e5") == 100 && "Undefended pawn is a clean win");
+    assert(see("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1", "d3e5") == -220 && "Knight for pawn once the x-ray batteries trade off");
+    assert(see("3rk3/3r4/8/3p4/8/8/3R4/3RK3 w - - 0 1", "d2d5") == -400 && "Doubled rooks recapture through each other");
+    assert(see("4k3/2p5/8/3pP3/8/8/8/4K3 w - d6 0 1", "e5d6") == 0 && "En passant removes the captured pawn");
+    assert(see("3rk3/2P5/8/8/8/8/8/4K3 w - - 0 1", "c7c8q") == -100 && "Promoting into a rook's file loses the pawn");
+    assert(see("3rk3/2P5/8/8/8/8/8/4K3 w - - 0 1", "c7d8q") == 400 && "King may only recapture an undefended piece");
+
+    // the threshold form must agree with the full swap list on every capture
+    // and promotion along random games
+    std::mt19937 rng(4901);
+    for (int gameIndex = 0; gameIndex < 100; ++gameIndex) {
+        Game game;
+        for (int ply = 0; ply < 120; ++ply) {
+            MovesStruct moves = game.generateAllLegalMoves();
+            if (moves.getNumMoves() == 0) break;
+            for (int i = 0; i < moves.getNumMoves(); ++i) {
+                Move move = moves.getMove(i);
+                if (!isCapture(move) && !isPromotion(move)) continue;
+                const int value = game.see(move);
+                for (int threshold : {-1000, -400, -100, -1, 0, 1, 100, 320, 900, value, value + 1}) {
+                    assert(game.seeGE(move, threshold) == (value >= threshold) && "seeGE should match see");
+                }
+            }
+            game.pushMove(moves.getMove(rng() % moves.getNumMoves()));
+        }
+    }
+}
+
+void test_incremental_eval_random_games() {
+    // the incrementally maintained eval must equal a full recompute after every
+    // push and pop, in both history modes
+    std::mt19937 rng(20240601);
+
+    for (int gameIndex = 0; gameIndex < 200; ++gameIndex) {
+        Game game;
+        bool fastMode = (gameIndex % 2) == 0;
+        if (fastMode) game.enableFastMode();
+
+        int maxPlies = fastMode ? 60 : 200; // the fast-mode stack only holds 64 states
+        int plies = 0;
+        for (; plies < maxPlies; ++plies) {
+            MovesStruct legalMoves = game.generateAllLegalMoves();
+            if (legalMoves.getNumMoves() == 0) break;
+
+            Move move = legalMoves.getMove(rng() % legalMoves.getNumMoves());
+            game.pushMove(move);
+            assert(evaluation::evaluateBoard(game.board) == evaluation::evaluateBoardFull(game.board) &&
+                   "Incremental eval should match full recompute after pushMove");
+            U64 pawnHash = game.board.pawnHash;
+            game.board.calculatePawnHash();
+            assert(pawnHash == game.board.pawnHash && "Incremental pawn key should match full recompute");
+        }
+
+        for (; plies > 0; --plies) {
+            game.popMove();
+            assert(evaluation::evaluateBoard(game.board) == evaluation::evaluateBoardFull(game.board) &&
+                   "Incremental eval should match full recompute after popMove");
+        }
+
+        if (fastMode) game.disableFastMode();
+    }
+}
+
+void test_tapered_eval() {
+    // colour-mirrored positions must evaluate to exactly the negated score
+    Board white("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
+    Board black("rnbqk2r/pppp1ppp/5n2/2b1p3/4P3/2N2N2/PPPP1PPP/R1BQKB1R b KQkq - 4 4");
+    assert(evaluation::evaluateBoard(white) == -evaluation::evaluateBoard(black) && "Eval should be colour symmetric");
+
+    // with only kings and pawns left the endgame king table applies: centralise
+    Board central("8/4k3/8/8/4K3/8/4P3/8 w - - 0 1");
+    Board corner("8/4k3/8/8/8/8/4P3/K7 w - - 0 1");
+    assert(central.psqt.phase == 0 && "Pawn endings should be phase 0");
+    assert(evaluation::evaluateBoard(central) > evaluation::evaluateBoard(corner) && "Endgame king should centralise");
+}
+
+void test_pawn_structure() {
+    pawns::PawnEntry entry;
+
+    // d6 sits in the front span of every white pawn, and d5/c3 in black's
+    Board blocked("4k3/8/3p4/3P4/8/2P5/2P5/4K3 w - - 0 1");
+    pawns::evaluatePawns(blocked, entry);
+    assert(entry.passedPawns[nWhite] == 0ULL && entry.passedPawns[nBlack] == 0ULL && "No pawn should be passed");
+
+    // a lone pawn is passed and isolated, and the bonus grows with its rank
+    Board rank4("4k3/8/8/8/4P3/8/8/4K3 w - - 0 1");
+    Board rank6("4k3/8/4P3/8/8/8/8/4K3 w - - 0 1");
+    pawns::evaluatePawns(rank4, entry);
+    assert(entry.passedPawns[nWhite] == (1ULL << 28) && "Lone e4 pawn should be passed");
+    int rank4Eg = entry.eg;
+    pawns::evaluatePawns(rank6, entry);
+    assert(entry.eg > rank4Eg && "Passed pawn bonus should grow with rank");
+
+    // doubled pawns score below the same number of pawns on separate files
+    Board doubled("4k3/8/8/8/8/4P3/4P3/4K3 w - - 0 1");
+    Board connected("4k3/8/8/8/8/3P4/4P3/4K3 w - - 0 1");
+    pawns::PawnEntry doubledEntry, connectedEntry;
+    pawns::evaluatePawns(doubled, doubledEntry);
+    pawns::evaluatePawns(connected, connectedEntry);
+    assert(doubledEntry.eg < connectedEntry.eg && "Doubled isolated pawns should be penalised");
+
+    // the pawn table returns the same terms as a direct evaluation
+    pawns::PawnHashTable table(64);
+    const pawns::PawnEntry& cached = table.probe(doubled);
+    assert(cached.mg == doubledEntry.mg && cached.eg == doubledEntry.eg);
+    table.probe(doubled);
+    assert(table.getProbes() == 2 && table.getHits() == 1 && "Second probe should hit");
+
+    // a castled king behind its pawns is safer than one with the shield advanced
+    Board shielded("4k3/8/8/8/8/8/5PPP/6K1 w - - 0 1");
+    Board exposed("4k3/8/8/8/5PPP/8/8/6K1 w - - 0 1");
+    assert(pawns::kingShield(shielded) > pawns::kingShield(exposed) && "Pawn shield should be rewarded");
+}
+
+std::unique_ptr<nnue::Network> makeRandomNetwork(std::mt19937& rng) {
+    std::unique_ptr<nnue::Network> net(new nnue::Network());
+    auto uniform = [&](int bound) { return static_cast<int>(rng() % (2 * bound + 1)) - bound; };
+
+    for (int16_t& w : net->featureWeights) w = static_cast<int16_t>(uniform(32));
+    for (int16_t& b : net->featureBias) b = static_cast<int16_t>(uniform(32));
+    for (int8_t& w : net->l1Weights) w = static_cast<int8_t>(uniform(64));
+    for (int32_t& b : net->l1Bias) b = uniform(8);
+    for (int8_t& w : net->outputWeights) w = static_cast<int8_t>(uniform(64));
+    net->outputBias = uniform(1000);
+    return net;
+}
+
+void test_nnue_accumulator() {
+    std::mt19937 rng(20240715);
+    nnue::setNetwork(makeRandomNetwork(rng));
+    nnue::setEnabled(true);
+    assert(nnue::isActive());
+
+    // incremental accumulator updates must match a refresh from scratch
+    for (int gameIndex = 0; gameIndex < 40; ++gameIndex) {
+        Game game;
+        if (gameIndex % 2 == 0) game.enableFastMode();
+        nnue::evaluate(game.board, game.currentAccumulator()); // computes the root
+
+        int plies = 0;
+        for (; plies < 60; ++plies) {
+            MovesStruct legalMoves = game.generateAllLegalMoves();
+            if (legalMoves.getNumMoves() == 0) break;
+            game.pushMove(legalMoves.getMove(rng() % legalMoves.getNumMoves()));
+
+            nnue::Accumulator fresh;
+            nnue::refreshAccumulator(game.board, fresh);
+            assert(game.currentAccumulator().computed && "pushMove should update the accumulator");
+            assert(std::memcmp(fresh.values, game.currentAccumulator().values, sizeof(fresh.values)) == 0 &&
+                   "Incremental accumulator should match a refresh");
+        }
+        for (; plies > 0; --plies) {
+            game.popMove();
+            nnue::Accumulator fresh;
+            nnue::refreshAccumulator(game.board, fresh);
+            assert(std::memcmp(fresh.values, game.currentAccumulator().values, sizeof(fresh.values)) == 0 &&
+                   "Accumulator should be restored by popMove");
+        }
+    }
+
+    // moves pushed while the network was off are replayed from the last
+    // computed entry once it is back on
+    Game catchUp;
+    catchUp.enableFastMode();
+    catchUp.refreshAccumulator();
+    nnue::setEnabled(false);
+    for (int ply = 0; ply < 4; ++ply) {
+        MovesStruct legalMoves = catchUp.generateAllLegalMoves();
+        catchUp.pushMove(legalMoves.getMove(rng() % legalMoves.getNumMoves()));
+    }
+    nnue::setEnabled(true);
+    MovesStruct catchUpMoves = catchUp.generateAllLegalMoves();
+    catchUp.pushMove(catchUpMoves.getMove(0));
+    nnue::Accumulator caughtUp;
+    nnue::refreshAccumulator(catchUp.board, caughtUp);
+    assert(catchUp.currentAccumulator().computed &&
+           std::memcmp(caughtUp.values, catchUp.currentAccumulator().values, sizeof(caughtUp.values)) == 0 &&
+           "Push should replay the deltas since the last computed accumulator");
+
+    // a new network makes every stored accumulator stale
+    catchUp.popMove();
+    nnue::setNetwork(makeRandomNetwork(rng));
+    catchUp.invalidateAccumulators();
+    assert(!catchUp.currentAccumulator().computed && "Invalidated accumulators should be recomputed");
+    catchUp.refreshAccumulator();
+    catchUp.pushMove(catchUpMoves.getMove(0));
+    nnue::refreshAccumulator(catchUp.board, caughtUp);
+    assert(std::memcmp(caughtUp.values, catchUp.currentAccumulator().values, sizeof(caughtUp.values)) == 0 &&
+           "Pushes after a network change should use the new weights");
+
+    // a search refreshes only its root; every other node is incremental
+    g_transpositionTable.clear();
+    threadEvalCache().clear();
+    setNodeLimit(-1);
+    g_searchStartTime = std::chrono::steady_clock::now();
+    g_timeLimit = 60000;
+    Game searched("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
+    searched.enableFastMode();
+    resetSearchStats();
+    nnue::resetRefreshCount();
+    searchAtDepth(searched, 4);
+    assert(g_nodeCount > 100 && nnue::refreshCount() == 1 && "Search should refresh the root accumulator only");
+    threadEvalCache().clear();
+
+    // both perspectives share the weights, so a colour-mirrored position scores the same for the side to move
+    Board white("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
+    Board black("rnbqk2r/pppp1ppp/5n2/2b1p3/4P3/2N2N2/PPPP1PPP/R1BQKB1R b KQkq - 4 4");
+    nnue::Accumulator whiteAcc, blackAcc;
+    assert(nnue::evaluate(white, whiteAcc) == nnue::evaluate(black, blackAcc) && "Network eval should be colour symmetric");
+
+    // weights survive a save/load round trip
+    const char* path = "nnue_test.bin";
+    int before = nnue::evaluate(white, whiteAcc);
+    assert(nnue::saveNetwork(path, *nnue::getNetwork()));
+    nnue::setNetwork(nullptr);
+    assert(!nnue::isActive() && "No network means handcrafted eval");
+    assert(nnue::loadNetwork(path));
+    nnue::Accumulator reloaded;
+    assert(nnue::evaluate(white, reloaded) == before && "Reloaded network should evaluate identically");
+    std::remove(path);
+
+    // oversized output weights are clamped below the mate scores
+    std::unique_ptr<nnue::Network> extreme = makeRandomNetwork(rng);
+    extreme->outputBias = 1 << 30;
+    nnue::setNetwork(std::move(extreme));
+    nnue::Accumulator extremeAcc;
+    assert(nnue::evaluate(white, extremeAcc) == nnue::MAX_EVAL && "Network eval should be clamped");
+
+    nnue::setEnabled(false);
+    nnue::setNetwork(nullptr);
+}
+
+void test_nnue_simd_kernels() {
+    // every vector backend must agree bit for bit with the scalar reference
+    std::mt19937 rng(20240716);
+    const int size = 512;
+
+    std::vector<int16_t> values(size), weights16(size), preactivation(size);
+    std::vector<int8_t> weights8(size);
+    std::vector<uint8_t> activations(size);
+    for (int i = 0; i < size; ++i) {
+        values[i] = static_cast<int16_t>(rng());          // full range, exercises wraparound
+        weights16[i] = static_cast<int16_t>(rng());
+        preactivation[i] = static_cast<int16_t>(static_cast<int>(rng() % 601) - 300);
+        weights8[i] = static_cast<int8_t>(rng());
+        activations[i] = static_cast<uint8_t>(rng() % 128);
+    }
+
+    const nnue::Kernels& scalar = nnue::kernelsFor(nnue::SimdBackend::Scalar);
+    std::vector<int16_t> expectedAdd = values, expectedSub = values;
+    scalar.addWeights(expectedAdd.data(), weights16.data(), size);
+    scalar.subWeights(expectedSub.data(), weights16.data(), size);
+    std::vector<uint8_t> expectedRelu(size);
+    scalar.clippedRelu(preactivation.data(), expectedRelu.data(), size);
+    int32_t expectedDot = scalar.dotProduct(activations.data(), weights8.data(), size);
+
+    std::mt19937 netRng(20240715);
+    nnue::setNetwork(makeRandomNetwork(netRng));
+    Board board("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
+    nnue::SimdBackend original = nnue::getSimdBackend();
+    nnue::setSimdBackend(nnue::SimdBackend::Scalar);
+    nnue::Accumulator scalarAcc;
+    int expectedEval = nnue::evaluate(board, scalarAcc);
+
+    for (nnue::SimdBackend backend : {nnue::SimdBackend::SSE41, nnue::SimdBackend::AVX2}) {
+        if (!nnue::cpuSupports(backend)) continue;
+        const nnue::Kernels& k = nnue::kernelsFor(backend);
+
+        std::vector<int16_t> added = values, subbed = values;
+        k.addWeights(added.data(), weights16.data(), size);
+        k.subWeights(subbed.data(), weights16.data(), size);
+        assert(added == expectedAdd && subbed == expectedSub && "SIMD accumulator update should match scalar");
+
+        std::vector<uint8_t> relu(size);
+        k.clippedRelu(preactivation.data(), relu.data(), size);
+        assert(relu == expectedRelu && "SIMD clipped ReLU should match scalar");
+        assert(k.dotProduct(activations.data(), weights8.data(), size) == expectedDot && "SIMD dot product should match scalar");
+
+        assert(nnue::setSimdBackend(backend));
+        nnue::Accumulator acc;
+        assert(nnue::evaluate(board, acc) == expectedEval && "Network eval should not depend on the backend");
+        assert(std::memcmp(acc.values, scalarAcc.values, sizeof(acc.values)) == 0);
+    }
+
+    nnue::setSimdBackend(original);
+    nnue::setNetwork(nullptr);
+}
+
+void test_eval_cache() {
+    EvalCache cache(1024);
+    int eval = 0;
+    U64 key = 0x123456789ABCDEF0ULL;
+
+    assert(!cache.probe(key, eval) && "Empty cache should miss");
+    cache.store(key, -345);
+    assert(cache.probe(key, eval) && eval == -345 && "Stored negative eval should round trip");
+
+    // same slot, different upper bits: must not return the other position's eval
+    assert(!cache.probe(key ^ (1ULL << 40), eval) && "Different key in the same slot should miss");
+    cache.store(key ^ (1ULL << 40), 77);
+    assert(!cache.probe(key, eval) && "Replaced entry should miss");
+
+    assert(cache.getHits() == 1 && cache.getMisses() == 3);
+}
+
+void test_tt_static_eval() {
+    TranspositionTable tt(1);
+    U64 key = 0xDEADBEEFCAFEF00DULL;
+
+    assert(tt.getStaticEval(key) == STATIC_EVAL_NONE && "Empty table has no static eval");
+    tt.store(key, 50, 0, TT_LOWER, MOVE_NONE, -123);
+    assert(tt.getStaticEval(key) == -123 && "Static eval should be stored with the entry");
+
+    // a deeper search result without an eval keeps the one already known
+    tt.store(key, 80, 3, TT_EXACT, MOVE_NONE);
+    int score = 0;
+    assert(tt.probe(key, -1000, 1000, 3, score) && score == 80);
+    assert(tt.getStaticEval(key) == -123 && "Storing without an eval should keep the old one");
+
+    // another position in the same slot replaces the entry, eval included
+    U64 other = key ^ (1ULL << 50);
+    tt.store(other, 10, 5, TT_EXACT, MOVE_NONE);
+    assert(tt.getStaticEval(key) == STATIC_EVAL_NONE && tt.getStaticEval(other) == STATIC_EVAL_NONE);
+}
+
+void test_batch_evaluate() {
+    std::vector<std::string> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - bm Qd8;", // EPD operations
+        "4k3/8/8/8/4P3/8/8/4K3 b - - 0 1",
+    };
+
+    // more threads than positions is allowed
+    std::vector<Board> boards = batch::parseFens(fens, 8);
+    std::vector<float> evals(boards.size());
+    std::vector<float> planes(boards.size() * evaluation::PLANE_SIZE);
+    batch::evaluate(boards.data(), boards.size(), evals.data(), planes.data(), 3);
+
+    for (size_t i = 0; i < boards.size(); ++i) {
+        Board single(fens[i].substr(0, fens[i].find(" bm")));
+        assert(boards[i].hash == single.hash && "Batch parse should match a single parse");
+        assert(evals[i] == static_cast<float>(evaluation::evaluateBoard(single)) && "Batch eval should match evaluateBoard");
+
+        std::vector<float> expected = evaluation::piecePlanes(single);
+        assert(std::equal(expected.begin(), expected.end(), planes.begin() + i * evaluation::PLANE_SIZE) &&
+               "Batch planes should match piecePlanes");
+    }
+
+    // packed records give the same results, and a corrupt one is flagged
+    std::vector<PackedPosition> packed;
+    for (const Board& board : boards) packed.push_back(board.encode());
+    PackedPosition corrupt = packed[0];
+    corrupt.occupancy = ~0ULL; // 64 pieces
+    packed.push_back(corrupt);
+    std::vector<float> packedEvals(packed.size());
+    std::vector<float> packedPlanes(packed.size() * evaluation::PLANE_SIZE, 1.0f);
+    size_t invalid = batch::evaluate(packed.data(), packed.size(), packedEvals.data(), packedPlanes.data(), 4);
+    assert(invalid == 1 && std::isnan(packedEvals.back()) && packedPlanes.back() == 0.0f && "Corrupt records should be flagged");
+    assert(std::equal(evals.begin(), evals.end(), packedEvals.begin()) &&
+           std::equal(planes.begin(), planes.end(), packedPlanes.begin()) && "Packed batch should match the board batch");
+}
+
+void test_fen_round_trip() {
+    std::vector<std::string> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2",
+        "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w Kq - 17 43",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 b - - 99 187",
+    };
+    for (const std::string& fen : fens) {
+        Board board;
+        assert(board.setFen(fen) && "Valid FEN should parse");
+        assert(board.toString() == fen && "FEN should round trip all six fields");
+        assert(board.hash == Board(board.toString()).hash);
+        Board full(fen);
+        full.calculateHash();
+        full.calculatePsqt();
+        assert(full.hash == board.hash && full.psqt == board.psqt && "Single-pass parse should match a recompute");
+    }
+
+    // counters are optional and EPD operations are ignored
+    Board epd;
+    assert(epd.setFen("4k3/8/8/8/8/8/8/4K3 w - - bm Kd2;"));
+    assert(epd.toString() == "4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+
+    Board bad;
+    assert(!bad.setFen("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1") && "Bad rank should be rejected");
+    assert(!bad.setFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1") && "Missing ranks should be rejected");
+    assert(!bad.setFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1") && "Bad side to move should be rejected");
+
+    // fullmove advances after black moves and is restored by popMove
+    Game game;
+    game.pushMove(game.generateAllLegalMoves().getMove(0));
+    assert(game.board.fullmoveNumber == 1);
+    game.pushMove(game.generateAllLegalMoves().getMove(0));
+    assert(game.board.fullmoveNumber == 2);
+    game.popMove();
+    assert(game.board.fullmoveNumber == 1);
+
+    // the halfmove clock can now reach the fifty-move limit
+    Game quiet("4k3/8/8/8/8/8/8/R3K3 w - - 99 80");
+    MovesStruct moves = quiet.generateAllLegalMoves();
+    for (int i = 0; i < moves.getNumMoves(); ++i) {
+        if (getFrom(moves.getMove(i)) == 0 && !isCapture(moves.getMove(i))) {
+            quiet.pushMove(moves.getMove(i));
+            break;
+        }
+    }
+    assert(quiet.board.getHalfMoveClock() == 100 && quiet.isFiftyMoveRule() && "Fifty-move rule should trigger");
+}
+
+void test_packed_position() {
+    std::mt19937 rng(37);
+    for (int gameIndex = 0; gameIndex < 20; ++gameIndex) {
+        Game game;
+        for (int ply = 0; ply < 120; ++ply) {
+            MovesStruct moves = game.generateAllLegalMoves();
+            if (moves.getNumMoves() == 0) break;
+            game.pushMove(moves.getMove(rng() % moves.getNumMoves()));
+
+            PackedPosition packed = game.board.encode();
+            Board decoded;
+            assert(decoded.decode(packed) && "Encoded position should decode");
+            assert(decoded.toString() == game.board.toString() && "Packed position should round trip all six fields");
+            assert(decoded.hash == game.board.hash && decoded.pawnHash == game.board.pawnHash);
+            assert(decoded.psqt == game.board.psqt);
+        }
+    }
+
+    Board board;
+    PackedPosition packed = board.encode();
+    packed.pieces[0] = 0xC; // piece code 12 does not exist
+    assert(!board.decode(packed) && "Bad piece code should be rejected");
+    packed = Board().encode();
+    packed.occupancy = ~0ULL; // 64 pieces but only 32 codes
+    assert(!board.decode(packed) && "Too many pieces should be rejected");
+}
+
+void test_selfplay() {
+    selfplay::Settings settings;
+    settings.nodes = 0;
+    settings.depth = 2;
+    settings.randomPlies = 4;
+    settings.maxPlies = 40;
+    settings.hashMb = 1;
+
+    TranspositionTable table(1);
+    setThreadTranspositionTable(&table);
+    std::mt19937_64 rng(38);
+    std::vector<PackedPosition> samples;
+    selfplay::GameResult result = selfplay::playGame(settings, rng, samples);
+    setThreadTranspositionTable(nullptr);
+
+    assert(!samples.empty() && "A 40-ply game should produce samples");
+    for (const PackedPosition& sample : samples) {
+        Board board;
+        assert(board.decode(sample) && "Samples should decode");
+        assert(selfplay::sampleResult(sample) == result && "Every sample carries the game result");
+        assert(std::abs(selfplay::sampleScore(sample)) < MATE_THRESHOLD && "Mate scores are not recorded");
+    }
+
+    PackedPosition record = Board().encode();
+    selfplay::setSample(record, -1234, selfplay::WHITE_WIN);
+    assert(selfplay::sampleScore(record) == -1234 && selfplay::sampleResult(record) == selfplay::WHITE_WIN);
+
+    // two workers write whole records, one per reported position
+    settings.threads = 2;
+    settings.games = 2;
+    std::FILE* out = std::tmpfile();
+    selfplay::Stats stats = selfplay::generate(settings, out);
+    assert(stats.games == 2);
+    assert(std::ftell(out) == static_cast<long>(stats.positions * sizeof(PackedPosition)));
+    std::fclose(out);
+}
+
+void test_texel_features() {
+    // the linear model reproduces the engine's evaluation with the built-in parameters
+    texel::Params params = texel::fromEvalParams(evaluation::params());
+    std::vector<texel::Feature> features;
+    std::vector<texel::Sample> samples;
+    std::mt19937 rng(39);
+    for (int gameIndex = 0; gameIndex < 10; ++gameIndex) {
+        Game game;
+        for (int ply = 0; ply < 80; ++ply) {
+            MovesStruct moves = game.generateAllLegalMoves();
+            if (moves.getNumMoves() == 0) break;
+            game.pushMove(moves.getMove(rng() % moves.getNumMoves()));
+
+            int phase = texel::extractFeatures(game.board, features);
+            double linear = texel::evaluate(params, features, phase);
+            assert(std::abs(linear - evaluation::evaluateBoard(game.board)) < 1.0 && "Linear eval should match evaluateBoard");
+            float result = static_cast<float>(rng() % 3) * 0.5f;
+            samples.push_back({game.board.encode(), result, result, static_cast<int>(std::lround(linear))});
+        }
+    }
+
+    // the analytic gradient agrees with a finite difference
+    texel::Params gradient;
+    texel::computeLoss(params, samples, 1.0, 2, &gradient);
+    const int term = texel::MATERIAL + 1; // knight
+    texel::Params shifted = params;
+    shifted.mg[term] += 0.5;
+    double up = texel::computeLoss(shifted, samples, 1.0, 1);
+    shifted.mg[term] -= 1.0;
+    double down = texel::computeLoss(shifted, samples, 1.0, 1);
+    assert(std::abs((up - down) - gradient.mg[term]) < 1e-6 && "Gradient should match finite difference");
+
+    // with the search score equal to the eval, fully blended targets are
+    // exactly what the model predicts at the same k
+    std::vector<texel::Sample> blended = samples;
+    texel::blendTargets(blended, 1.0, 1.7);
+    assert(texel::computeLoss(params, blended, 1.7, 2) < 1e-6 && "Blended targets should use the loss's k");
+
+    // a hanging queen is resolved to the position after it is taken
+    Board hanging("4k3/8/8/3q4/4P3/8/8/4K3 w - - 0 1");
+    Board leaf = texel::resolveLeaf(hanging);
+    assert(!leaf.pieceBB[nQueens] && "Leaf should be after the capture");
+    Board quiet("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1");
+    assert(texel::resolveLeaf(quiet).toString() == quiet.toString() && "Quiet position is its own leaf");
+}
+
+void test_eval_params_file() {
+    const std::string path = "test_eval_params.tmp";
+
+    // save/load round trip of every field
+    evaluation::EvalParams loaded;
+    assert(evaluation::saveParams(path, evaluation::DEFAULT_PARAMS));
+    assert(evaluation::loadParams(path, loaded) && "Saved parameters should load");
+    assert(std::memcmp(&loaded, &evaluation::DEFAULT_PARAMS, sizeof(loaded)) == 0 && "Parameters should round trip");
+
+    // partial files keep the defaults for everything else, unknown names are errors
+    {
+        std::ofstream out(path);
+        out << "# pawn bonus\npieceValueMg 150 320 330 500 900 0\ndoubledEg -30\n";
+    }
+    assert(evaluation::loadParams(path, loaded));
+    assert(loaded.pieceValueMg[0] == 150 && loaded.doubledEg == -30);
+    assert(loaded.pstMg[1][27] == evaluation::DEFAULT_PARAMS.pstMg[1][27]);
+    {
+        std::ofstream out(path);
+        out << "knightOutpost 10\n";
+    }
+    assert(!evaluation::loadParams(path, loaded) && "Unknown field should be rejected");
+    std::remove(path.c_str());
+
+    if (!evaluation::PARAMS_LOADABLE) return;
+
+    // new weights reach the incremental psqt of boards built afterwards
+    Board before("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1");
+    evaluation::EvalParams heavyPawns = evaluation::DEFAULT_PARAMS;
+    heavyPawns.pieceValueMg[0] += 50;
+    heavyPawns.pieceValueEg[0] += 50;
+    assert(evaluation::setParams(heavyPawns));
+    pawns::threadTable().clear();
+    Board after("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1");
+    assert(after.psqt.eg == before.psqt.eg + 50);
+    assert(evaluation::evaluateBoard(after) == evaluation::evaluateBoardFull(after));
+    evaluation::setParams(evaluation::DEFAULT_PARAMS);
+    pawns::threadTable().clear();
+}
+
+void test_search_finds_tactics() {
+    g_transpositionTable.clear();
+    setNodeLimit(-1);
+    g_searchStartTime = std::chrono::steady_clock::now();
+    g_timeLimit = 60000;
+
+    // back-rank mate in one
+    Game mate("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+    mate.enableFastMode();
+    resetSearchStats();
+    int score = 0;
+    Move best = searchAtDepth(mate, 4, nullptr, &score);
+    assert(moveToString(best) == "d1d8" && score > MATE_THRESHOLD && "Search should find the back-rank mate");
+
+    // an undefended queen is taken
+    Game hanging("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+    hanging.enableFastMode();
+    resetSearchStats();
+    best = searchAtDepth(hanging, 4, nullptr, &score);
+    assert(moveToString(best) == "d2d5" && score > 300 && "Search should win the hanging queen");
+    assert(g_pvNodes > 0 && g_pvNodes < g_nodeCount && "Most nodes should be searched with a null window");
+
+    // the root list carries over between iterations with the best move on top
+    g_transpositionTable.clear();
+    std::vector<RootMove> rootMoves = generateRootMoves(hanging);
+    for (int depth = 1; depth <= 4; ++depth) {
+        score = searchRoot(hanging, rootMoves, depth);
+        assert(moveToString(rootMoves[0].move) == "d2d5" && rootMoves[0].score == score && "Best root move should lead the list");
+    }
+    for (const RootMove& rootMove : rootMoves) {
+        assert(rootMove.nodes > 0 && "Every root move should record its subtree size");
+    }
+
+    // a window centred far from the true score has to widen until it fits
+    g_transpositionTable.clear();
+    resetSearchStats();
+    rootMoves = generateRootMoves(hanging);
+    int aspirationScore = searchRootAspiration(hanging, rootMoves, 4, -500);
+    assert(aspirationScore == score && g_aspirationFailHighs > 0 && "Aspiration search should widen to the full-window score");
+
+    // a fail low keeps the previous best in front, and a stop before the
+    // window is wide enough discards the iteration
+    rootMoves = generateRootMoves(hanging);
+    std::swap(rootMoves[0], rootMoves.back());
+    const Move previousBest = rootMoves[0].move;
+    assert(moveToString(previousBest) != "d2d5");
+    g_transpositionTable.clear();
+    resetSearchStats();
+    int failLow = searchRoot(hanging, rootMoves, 4, 3000 - ASPIRATION_WINDOW, 3000 + ASPIRATION_WINDOW);
+    assert(failLow <= 3000 - ASPIRATION_WINDOW && rootMoves[0].move == previousBest && "A fail low should not reorder the root moves");
+
+    // the same first window again, stopped just after its first move failed low
+    const long firstMoveNodes = rootMoves[0].nodes;
+    g_transpositionTable.clear();
+    resetSearchStats();
+    setNodeLimit(firstMoveNodes + 1);
+    aspirationScore = searchRootAspiration(hanging, rootMoves, 4, 3000);
+    setNodeLimit(-1);
+    assert(aspirationScore == ROOT_SCORE_NONE && rootMoves[0].move == previousBest && "A stop during a fail low should report no result");
+}
+
+
+void test_move_history() {
+    resetSearchStats();
+
+    // gravity keeps entries inside +-HISTORY_MAX however often they are hit
+    int entry = 0;
+    for (int i = 0; i < 1000; ++i) updateHistory(entry, historyBonus(MAX_SEARCH_DEPTH));
+    assert(entry > 0 && entry <= HISTORY_MAX && "History should saturate below HISTORY_MAX");
+    for (int i = 0; i < 1000; ++i) updateHistory(entry, -historyBonus(MAX_SEARCH_DEPTH));
+    assert(entry < 0 && entry >= -HISTORY_MAX && "History should saturate above -HISTORY_MAX");
+
+    // after 1. e4 (the root move here), Nf6 refutes and a6 failed before it
+    Game game;
+    game.enableFastMode();
+    MovesStruct moves = game.generateAllLegalMoves();
+    for (int i = 0; i < moves.getNumMoves(); ++i) {
+        if (moveToString(moves.getMove(i)) != "e2e4") continue;
+        g_searchStack[0] = {moves.getMove(i), game.board.getPieceIndex(getFrom(moves.getMove(i)))};
+        game.pushMove(moves.getMove(i));
+    }
+    assert(counterMove(game) == MOVE_NONE && "No counter move before any update");
+
+    Move cutoff = MOVE_NONE, failed = MOVE_NONE;
+    moves = game.generateAllLegalMoves();
+    for (int i = 0; i < moves.getNumMoves(); ++i) {
+        if (moveToString(moves.getMove(i)) == "g8f6") cutoff = moves.getMove(i);
+        if (moveToString(moves.getMove(i)) == "a7a6") failed = moves.getMove(i);
+    }
+    updateQuietHistory(game, cutoff, &failed, 1, 4, 1);
+    assert(counterMove(game) == cutoff && "The refutation should become the counter move");
+    assert(g_history[nBlack][getFrom(cutoff)][getTo(cutoff)] > 0 && g_history[nBlack][getFrom(failed)][getTo(failed)] < 0 &&
+           "Cutoff move gains history, failed quiets lose it");
+
+    // the continuation entry behind e4 doubles the butterfly score
+    const int butterfly = g_history[nBlack][getFrom(cutoff)][getTo(cutoff)];
+    assert(quietHistoryScore(game, cutoff, 1) == 2 * butterfly && "Continuation history should follow the previous move");
+    assert(quietHistoryScore(game, cutoff, 0) == butterfly && "Without earlier moves only the butterfly score counts");
+
+    game.pushNullMove();
+    assert(counterMove(game) == MOVE_NONE && "A null move has no counter move");
+    game.popNullMove();
+
+    // capture history shifts captures within their MVV-LVA class
+    Game captures("4k3/8/2n1n3/3P4/8/8/8/4K3 w - - 0 1");
+    Move good = MOVE_NONE, bad = MOVE_NONE;
+    moves = captures.generateAllLegalMoves(true);
+    for (int i = 0; i < moves.getNumMoves(); ++i) {
+        if (moveToString(moves.getMove(i)) == "d5e6") good = moves.getMove(i);
+        if (moveToString(moves.getMove(i)) == "d5c6") bad = moves.getMove(i);
+    }
+    assert(captureOrderScore(captures, good) == captureOrderScore(captures, bad) && "Equal captures start level");
+    updateCaptureHistory(captures, good, &bad, 1, historyBonus(8));
+    assert(captureHistoryEntry(captures, good) > 0 && captureHistoryEntry(captures, bad) < 0 &&
+           captureOrderScore(captures, good) > captureOrderScore(captures, bad) && "Capture history should reorder equal captures");
+
+    // en passant is a pawn capture and updates only its own entry
+    resetSearchStats();
+    Game enPassant("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+    Move ep = MOVE_NONE;
+    moves = enPassant.generateAllLegalMoves(true);
+    for (int i = 0; i < moves.getNumMoves(); ++i) {
+        if (moveToString(moves.getMove(i)) == "e5d6") ep = moves.getMove(i);
+    }
+    assert(isEPCapture(ep) && getCapturedPiece(ep) == nPawns && "En passant should record a captured pawn");
+    assert(captureOrderScore(enPassant, ep) == evaluation::pieceScore(nPawns) / 10 - evaluation::pieceScore(nPawns) / 100 &&
+           "En passant should order as pawn takes pawn");
+    updateCaptureHistory(enPassant, ep, nullptr, 0, historyBonus(8));
+    long otherEntries = 0;
+    for (int piece = 0; piece < 12; ++piece) {
+        for (int to = 0; to < 64; ++to) {
+            for (int captured = 0; captured < 6; ++captured) otherEntries += std::abs(g_captureHistory[piece][to][captured]);
+        }
+    }
+    otherEntries -= captureHistoryEntry(enPassant, ep);
+    assert(captureHistoryEntry(enPassant, ep) > 0 && otherEntries == 0 && "En passant should update only its own entry");
+    resetSearchStats();
+}
+
+void test_lmr_table() {
+    // reductions grow with depth and move number and follow the UCI parameters
+    assert(lmrReduction(10, 1) == lmrReduction(1, 10) && "One factor at ln(1) = 0 leaves only the base");
+    for (int depth = 2; depth <= MAX_SEARCH_DEPTH; ++depth) {
+        for (int moveNumber = 2; moveNumber < LMR_TABLE_MOVES; ++moveNumber) {
+            assert(lmrReduction(depth, moveNumber) >= lmrReduction(depth - 1, moveNumber) && "Reduction should not shrink with depth");
+            assert(lmrReduction(depth, moveNumber) >= lmrReduction(depth, moveNumber - 1) && "Reduction should not shrink with move number");
+        }
+    }
+
+    int before = lmrReduction(20, 40);
+    assert(setSearchTunable("LmrDivisor", 100) && lmrReduction(20, 40) > before && "A smaller divisor should reduce more");
+    assert(setSearchTunable("LmrDivisor", 225) && lmrReduction(20, 40) == before && "Restoring the divisor should restore the table");
+    assert(!setSearchTunable("NoSuchOption", 1) && "Unknown names should be rejected");
+
+    // reductions at depth 1 and 2 have no room left and must stay at zero
+    assert(setSearchTunable("LmrMinDepth", 1) && setSearchTunable("LmrMinMoves", 1));
+    g_transpositionTable.clear();
+    setNodeLimit(-1);
+    g_searchStartTime = std::chrono::steady_clock::now();
+    g_timeLimit = 60000;
+    Game game("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+    game.enableFastMode();
+    resetSearchStats();
+    assert(moveToString(searchAtDepth(game, 4)) == "d2d5" && "Shallow LMR should still find the hanging queen");
+    setSearchTunable("LmrMinDepth", 3);
+    setSearchTunable("LmrMinMoves", 3);
+}
+
+void test_leaf_pruning() {
+    g_transpositionTable.clear();
+    setNodeLimit(-1);
+    g_searchStartTime = std::chrono::steady_clock::now();
+    g_timeLimit = 60000;
+
+    // a queen up against a null window at zero: reverse futility returns the
+    // static eval without searching a move
+    Game ahead("4k3/8/8/8/8/8/3Q4/4K3 w - - 0 1");
+    ahead.enableFastMode();
+    resetSearchStats();
+    int score = alphabeta(-1, 0, 2, ahead, NON_PV_NODE);
+    assert(g_reverseFutilityCutoffs == 1 && g_nodeCount == 1 && score == evalForSide(ahead) && "Reverse futility should cut at the root");
+
+    // not at PV nodes or in check (depth 1 so the children are qsearch)
+    g_transpositionTable.clear();
+    resetSearchStats();
+    alphabeta(-1, 0, 1, ahead, PV_NODE);
+    Game checked("4k3/8/8/8/8/8/3Q4/4K2r w - - 0 1");
+    checked.enableFastMode();
+    alphabeta(-1, 0, 1, checked, NON_PV_NODE);
+    assert(g_reverseFutilityCutoffs == 0 && g_razorTries == 0 && g_futilityPrunes == 0 && "Leaf pruning is off at PV nodes and in check");
+
+    // a queen down: razoring trusts the failing qsearch, and with razoring
+    // off the quiet moves are pruned by futility instead
+    Game behind("3qk3/8/8/8/8/8/8/4K3 w - - 0 1");
+    behind.enableFastMode();
+    g_transpositionTable.clear();
+    resetSearchStats();
+    alphabeta(-1, 0, 2, behind, NON_PV_NODE);
+    assert(g_razorCutoffs == 1 && g_futilityPrunes == 0 && "Razoring should fail low at the root");
+
+    setSearchTunable("RazorMaxDepth", 0);
+    g_transpositionTable.clear();
+    resetSearchStats();
+    alphabeta(-1, 0, 2, behind, NON_PV_NODE);
+    assert(g_razorTries == 0 && g_futilityPrunes > 0 && "Futility should skip quiet king moves");
+    setSearchTunable("RazorMaxDepth", 3);
+}
 
 int main() {
     test_checkmate();
@@ -121,6 +988,27 @@ int main() {
     test_pawn_promotions();
     test_pinned_piece_cannot_move();
     test_king_cannot_move_into_check();
+    test_slider_tables();
+    test_start_position_hash();
+    test_null_move();
+    test_static_exchange();
+    test_incremental_eval_random_games();
+    test_tapered_eval();
+    test_pawn_structure();
+    test_nnue_accumulator();
+    test_nnue_simd_kernels();
+    test_eval_cache();
+    test_tt_static_eval();
+    test_batch_evaluate();
+    test_fen_round_trip();
+    test_packed_position();
+    test_selfplay();
+    test_texel_features();
+    test_eval_params_file();
+    test_search_finds_tactics();
+    test_lmr_table();
+    test_leaf_pruning();
+    test_move_history();
 
     std::cout << "All tests passed!" << std::endl;
     return 0;
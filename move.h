@@ -140,7 +140,8 @@ inline Move makeMove(U8 from, U8 to, int epSquare, enumPiece piece, enumPiece ta
         m = setFlags(m, QUIET_MOVES); // quiet move
     }
 
-    m = setCapturedPiece(m, target);
+    // en passant takes a pawn even though the target square is empty
+    m = setCapturedPiece(m, isEnPassant ? nPawns : target);
     return m;
 }
 
@@ -0,0 +1,201 @@
+#include "nnue.h"
+#include "nnue_simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace nnue {
+
+static_assert(QA == 127, "the clippedRelu kernels saturate to int8");
+static_assert(HIDDEN % 32 == 0 && L1_SIZE % 32 == 0, "kernels work on 32-element blocks");
+
+namespace {
+
+std::unique_ptr<Network> g_network;
+bool g_enabled = false;
+thread_local long g_refreshes = 0;
+
+inline int mirrorFeature(int feature) {
+    int pieceIndex = feature / 64;
+    int square = feature % 64;
+    return featureIndex(pieceIndex, square, nBlack);
+}
+
+inline void addFeature(int16_t* values, const Network& net, int feature) {
+    kernels().addWeights(values, net.featureWeights + feature * HIDDEN, HIDDEN);
+}
+
+inline void removeFeature(int16_t* values, const Network& net, int feature) {
+    kernels().subWeights(values, net.featureWeights + feature * HIDDEN, HIDDEN);
+}
+
+void applyDelta(const Network& net, const Accumulator& previous, const FeatureDelta& delta, Accumulator& next) {
+    std::memcpy(next.values, previous.values, sizeof(next.values));
+    for (int i = 0; i < delta.numRemoved; ++i) {
+        removeFeature(next.values[nWhite], net, delta.removed[i]);
+        removeFeature(next.values[nBlack], net, mirrorFeature(delta.removed[i]));
+    }
+    for (int i = 0; i < delta.numAdded; ++i) {
+        addFeature(next.values[nWhite], net, delta.added[i]);
+        addFeature(next.values[nBlack], net, mirrorFeature(delta.added[i]));
+    }
+    next.computed = true;
+}
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t inputs;
+    uint32_t hidden;
+    uint32_t l1Size;
+};
+
+} // namespace
+
+int featureIndex(int pieceIndex, int square, int perspective) {
+    if (perspective == nWhite) return pieceIndex * 64 + square;
+    // black sees the board flipped with the colours swapped
+    return ((pieceIndex + 6) % 12) * 64 + (square ^ 56);
+}
+
+void AccumulatorStack::reset() {
+    index = 0;
+    stack[0].computed = false;
+}
+
+void AccumulatorStack::invalidate() {
+    for (Accumulator& accumulator : stack) accumulator.computed = false;
+}
+
+void AccumulatorStack::push(const FeatureDelta& delta) {
+    if (index + 1 == stack.size()) { // may reallocate, take references after
+        stack.emplace_back();
+        deltas.emplace_back();
+    }
+    deltas[++index] = delta;
+    stack[index].computed = false;
+    if (!isActive()) return;
+
+    // entries pushed while nothing below them was computed catch up here
+    size_t base = index - 1;
+    while (base > 0 && !stack[base].computed) --base;
+    if (!stack[base].computed) return;
+
+    const Network& net = *g_network;
+    for (size_t i = base + 1; i <= index; ++i) applyDelta(net, stack[i - 1], deltas[i], stack[i]);
+}
+
+void AccumulatorStack::pop() {
+    if (index > 0) --index;
+}
+
+void AccumulatorStack::refresh(const Board& board) {
+    if (isActive() && !stack[index].computed) refreshAccumulator(board, stack[index]);
+}
+
+bool loadNetwork(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    FileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION ||
+        header.inputs != INPUTS || header.hidden != HIDDEN || header.l1Size != L1_SIZE) {
+        return false;
+    }
+
+    std::unique_ptr<Network> net(new Network());
+    in.read(reinterpret_cast<char*>(net->featureWeights), sizeof(net->featureWeights));
+    in.read(reinterpret_cast<char*>(net->featureBias), sizeof(net->featureBias));
+    in.read(reinterpret_cast<char*>(net->l1Weights), sizeof(net->l1Weights));
+    in.read(reinterpret_cast<char*>(net->l1Bias), sizeof(net->l1Bias));
+    in.read(reinterpret_cast<char*>(net->outputWeights), sizeof(net->outputWeights));
+    in.read(reinterpret_cast<char*>(&net->outputBias), sizeof(net->outputBias));
+    if (!in) return false;
+
+    setNetwork(std::move(net));
+    return true;
+}
+
+bool saveNetwork(const std::string& path, const Network& net) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    FileHeader header = {FILE_MAGIC, FILE_VERSION, INPUTS, HIDDEN, L1_SIZE};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(net.featureWeights), sizeof(net.featureWeights));
+    out.write(reinterpret_cast<const char*>(net.featureBias), sizeof(net.featureBias));
+    out.write(reinterpret_cast<const char*>(net.l1Weights), sizeof(net.l1Weights));
+    out.write(reinterpret_cast<const char*>(net.l1Bias), sizeof(net.l1Bias));
+    out.write(reinterpret_cast<const char*>(net.outputWeights), sizeof(net.outputWeights));
+    out.write(reinterpret_cast<const char*>(&net.outputBias), sizeof(net.outputBias));
+    return static_cast<bool>(out);
+}
+
+void setNetwork(std::unique_ptr<Network> network) {
+    g_network = std::move(network);
+}
+
+const Network* getNetwork() {
+    return g_network.get();
+}
+
+void setEnabled(bool enabled) {
+    g_enabled = enabled;
+}
+
+bool isActive() {
+    return g_enabled && g_network;
+}
+
+void refreshAccumulator(const Board& board, Accumulator& accumulator) {
+    g_refreshes++;
+    const Network& net = *g_network;
+    for (int perspective = nBlack; perspective <= nWhite; ++perspective) {
+        int16_t* values = accumulator.values[perspective];
+        std::memcpy(values, net.featureBias, sizeof(net.featureBias));
+
+        U64 pieces = board.getAllPieces();
+        while (pieces) {
+            int square = __builtin_ctzll(pieces);
+            pieces &= pieces - 1;
+            addFeature(values, net, featureIndex(board.getPieceIndex(square), square, perspective));
+        }
+    }
+    accumulator.computed = true;
+}
+
+long refreshCount() {
+    return g_refreshes;
+}
+
+void resetRefreshCount() {
+    g_refreshes = 0;
+}
+
+int evaluate(const Board& board, Accumulator& accumulator) {
+    const Network& net = *g_network;
+    if (!accumulator.computed) refreshAccumulator(board, accumulator);
+
+    // side to move first, then the opponent
+    const int us = (board.gameInfo & TURN_MASK) ? nWhite : nBlack;
+    const Kernels& k = kernels();
+    alignas(64) uint8_t input[2 * HIDDEN];
+    k.clippedRelu(accumulator.values[us], input, HIDDEN);
+    k.clippedRelu(accumulator.values[us ^ 1], input + HIDDEN, HIDDEN);
+
+    alignas(64) uint8_t hidden[L1_SIZE];
+    for (int neuron = 0; neuron < L1_SIZE; ++neuron) {
+        int32_t sum = k.dotProduct(input, net.l1Weights + neuron * 2 * HIDDEN, 2 * HIDDEN);
+        sum = net.l1Bias[neuron] + (sum >> WEIGHT_SHIFT);
+        hidden[neuron] = static_cast<uint8_t>(std::clamp<int32_t>(sum, 0, QA));
+    }
+
+    int32_t output = net.outputBias + k.dotProduct(hidden, net.outputWeights, L1_SIZE);
+
+    const int64_t score = static_cast<int64_t>(output) * EVAL_SCALE / (QA * QB);
+    return static_cast<int>(std::clamp<int64_t>(score, -MAX_EVAL, MAX_EVAL));
+}
+
+} // namespace nnue
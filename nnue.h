@@ -0,0 +1,120 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include "board.h"
+#include "types.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Efficiently updatable network evaluation (inner loops in nnue_simd.h).
+//
+// 768 inputs (12 pieces x 64 squares, the same layout as evaluation::piecePlanes)
+// feed a HIDDEN-wide int16 accumulator per perspective. The side to move's
+// accumulator is concatenated with the opponent's, clipped to [0, 127] and run
+// through an int8 dense layer of L1_SIZE neurons and an int8 output neuron.
+//
+// The accumulators live on a stack in Game: pushMove derives the next entry
+// from the previous one using only the pieces that were added or removed,
+// popMove just drops back one entry. The search refreshes the root entry
+// once, so everything below it stays incremental.
+
+namespace nnue {
+
+const int INPUTS = 768;
+const int HIDDEN = 256;
+const int L1_SIZE = 32;
+
+// quantisation: accumulator activations are clipped to [0, QA], dense weights
+// are scaled by QB (= 1 << WEIGHT_SHIFT)
+const int QA = 127;
+const int WEIGHT_SHIFT = 6;
+const int QB = 1 << WEIGHT_SHIFT;
+// network output is in units of QA * QB per EVAL_SCALE centipawns
+const int EVAL_SCALE = 400;
+// evaluate() is clamped to +-MAX_EVAL: below the search's mate scores
+// (MATE_THRESHOLD in search.h) and inside the int16 eval cache and TT fields
+const int MAX_EVAL = 28999;
+
+const uint32_t FILE_MAGIC = 0x45554E4E; // "NNUE"
+const uint32_t FILE_VERSION = 1;
+
+struct Network {
+    alignas(64) int16_t featureWeights[INPUTS * HIDDEN]; // [feature][hidden]
+    alignas(64) int16_t featureBias[HIDDEN];
+    alignas(64) int8_t l1Weights[L1_SIZE * 2 * HIDDEN];  // [neuron][input]
+    alignas(64) int32_t l1Bias[L1_SIZE];                 // added after the WEIGHT_SHIFT
+    alignas(64) int8_t outputWeights[L1_SIZE];
+    int32_t outputBias;
+};
+
+struct Accumulator {
+    alignas(64) int16_t values[2][HIDDEN]; // indexed by nBlack / nWhite perspective
+    bool computed = false;
+};
+
+// pieces touched by one move, as white-perspective feature indices
+// (getPieceIndex * 64 + square)
+struct FeatureDelta {
+    int added[2];
+    int removed[3];
+    int numAdded = 0;
+    int numRemoved = 0;
+
+    void add(int pieceIndex, int square) { added[numAdded++] = pieceIndex * 64 + square; }
+    void remove(int pieceIndex, int square) { removed[numRemoved++] = pieceIndex * 64 + square; }
+};
+
+class AccumulatorStack {
+public:
+    AccumulatorStack() : stack(1), deltas(1) {}
+
+    // forget everything, e.g. after the board was replaced
+    void reset();
+    // keeps the positions but drops every computed value, e.g. after the
+    // network changed
+    void invalidate();
+    // derive the next accumulator from the nearest computed one below it,
+    // replaying the deltas in between; only does work while a network is
+    // active, and with nothing computed the new entry is refreshed lazily
+    void push(const FeatureDelta& delta);
+    void pop();
+    // full refresh of the current entry unless it is already computed
+    void refresh(const Board& board);
+
+    Accumulator& current() { return stack[index]; }
+
+private:
+    std::vector<Accumulator> stack;
+    std::vector<FeatureDelta> deltas; // deltas[i] leads from entry i - 1 to entry i
+    size_t index = 0;
+};
+
+// file format: u32 magic, u32 version, u32 inputs, u32 hidden, u32 l1 size,
+// followed by the Network arrays in declaration order (little-endian)
+bool loadNetwork(const std::string& path);
+bool saveNetwork(const std::string& path, const Network& network);
+
+// installs a network directly (tests, tools)
+void setNetwork(std::unique_ptr<Network> network);
+const Network* getNetwork();
+
+// UseNNUE: the network is only used when enabled and loaded
+void setEnabled(bool enabled);
+bool isActive();
+
+int featureIndex(int pieceIndex, int square, int perspective);
+
+void refreshAccumulator(const Board& board, Accumulator& accumulator);
+// full refreshes done by this thread since the last reset
+long refreshCount();
+void resetRefreshCount();
+
+// side-to-move score in centipawns, refreshes the accumulator if needed
+int evaluate(const Board& board, Accumulator& accumulator);
+
+} // namespace nnue
+
+#endif // NNUE_H
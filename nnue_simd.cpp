@@ -0,0 +1,185 @@
+#include "nnue_simd.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) && !defined(_MSC_VER)
+#include <immintrin.h>
+#define NNUE_X86_SIMD_AVAILABLE 1
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace nnue {
+
+namespace {
+
+// scalar reference, also the fallback on other architectures
+
+void addWeightsScalar(int16_t* values, const int16_t* weights, int size) {
+    for (int i = 0; i < size; ++i) values[i] = static_cast<int16_t>(values[i] + weights[i]);
+}
+
+void subWeightsScalar(int16_t* values, const int16_t* weights, int size) {
+    for (int i = 0; i < size; ++i) values[i] = static_cast<int16_t>(values[i] - weights[i]);
+}
+
+void clippedReluScalar(const int16_t* input, uint8_t* output, int size) {
+    for (int i = 0; i < size; ++i) output[i] = static_cast<uint8_t>(std::clamp<int>(input[i], 0, 127));
+}
+
+int32_t dotProductScalar(const uint8_t* input, const int8_t* weights, int size) {
+    int32_t sum = 0;
+    for (int i = 0; i < size; ++i) sum += input[i] * weights[i];
+    return sum;
+}
+
+#if defined(NNUE_X86_SIMD_AVAILABLE)
+
+TARGET_SSE41 void addWeightsSSE41(int16_t* values, const int16_t* weights, int size) {
+    for (int i = 0; i < size; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), _mm_add_epi16(v, w));
+    }
+}
+
+TARGET_SSE41 void subWeightsSSE41(int16_t* values, const int16_t* weights, int size) {
+    for (int i = 0; i < size; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), _mm_sub_epi16(v, w));
+    }
+}
+
+TARGET_SSE41 void clippedReluSSE41(const int16_t* input, uint8_t* output, int size) {
+    const __m128i zero = _mm_setzero_si128();
+    for (int i = 0; i < size; i += 16) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8));
+        // signed saturation to [-128, 127], then drop the negatives
+        __m128i packed = _mm_max_epi8(_mm_packs_epi16(lo, hi), zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+    }
+}
+
+TARGET_SSE41 int32_t dotProductSSE41(const uint8_t* input, const int8_t* weights, int size) {
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < size; i += 16) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        // u8 * i8 pairs into i16; cannot saturate while inputs are <= 127
+        __m128i products = _mm_maddubs_epi16(in, w);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(products, ones));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+TARGET_AVX2 void addWeightsAVX2(int16_t* values, const int16_t* weights, int size) {
+    for (int i = 0; i < size; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), _mm256_add_epi16(v, w));
+    }
+}
+
+TARGET_AVX2 void subWeightsAVX2(int16_t* values, const int16_t* weights, int size) {
+    for (int i = 0; i < size; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), _mm256_sub_epi16(v, w));
+    }
+}
+
+TARGET_AVX2 void clippedReluAVX2(const int16_t* input, uint8_t* output, int size) {
+    const __m256i zero = _mm256_setzero_si256();
+    for (int i = 0; i < size; i += 32) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i + 16));
+        __m256i packed = _mm256_max_epi8(_mm256_packs_epi16(lo, hi), zero);
+        // packs works per 128-bit lane, restore element order
+        packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+    }
+}
+
+TARGET_AVX2 int32_t dotProductAVX2(const uint8_t* input, const int8_t* weights, int size) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < size; i += 32) {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        __m256i products = _mm256_maddubs_epi16(in, w);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(half);
+}
+
+#endif
+
+const Kernels SCALAR_KERNELS = {addWeightsScalar, subWeightsScalar, clippedReluScalar, dotProductScalar};
+#if defined(NNUE_X86_SIMD_AVAILABLE)
+const Kernels SSE41_KERNELS = {addWeightsSSE41, subWeightsSSE41, clippedReluSSE41, dotProductSSE41};
+const Kernels AVX2_KERNELS = {addWeightsAVX2, subWeightsAVX2, clippedReluAVX2, dotProductAVX2};
+#endif
+
+SimdBackend bestBackend() {
+    if (cpuSupports(SimdBackend::AVX2)) return SimdBackend::AVX2;
+    if (cpuSupports(SimdBackend::SSE41)) return SimdBackend::SSE41;
+    return SimdBackend::Scalar;
+}
+
+SimdBackend g_backend = bestBackend();
+const Kernels* g_kernels = &kernelsFor(g_backend);
+
+} // namespace
+
+const Kernels& kernels() {
+    return *g_kernels;
+}
+
+const Kernels& kernelsFor(SimdBackend backend) {
+#if defined(NNUE_X86_SIMD_AVAILABLE)
+    if (backend == SimdBackend::AVX2) return AVX2_KERNELS;
+    if (backend == SimdBackend::SSE41) return SSE41_KERNELS;
+#else
+    (void)backend;
+#endif
+    return SCALAR_KERNELS;
+}
+
+bool cpuSupports(SimdBackend backend) {
+    if (backend == SimdBackend::Scalar) return true;
+#if defined(NNUE_X86_SIMD_AVAILABLE)
+    __builtin_cpu_init();
+    if (backend == SimdBackend::AVX2) return __builtin_cpu_supports("avx2");
+    if (backend == SimdBackend::SSE41) return __builtin_cpu_supports("sse4.1");
+#endif
+    return false;
+}
+
+bool setSimdBackend(SimdBackend backend) {
+    if (!cpuSupports(backend)) return false;
+    g_backend = backend;
+    g_kernels = &kernelsFor(backend);
+    return true;
+}
+
+SimdBackend getSimdBackend() {
+    return g_backend;
+}
+
+const char* simdBackendName(SimdBackend backend) {
+    switch (backend) {
+        case SimdBackend::AVX2: return "avx2";
+        case SimdBackend::SSE41: return "sse4.1";
+        default: return "scalar";
+    }
+}
+
+} // namespace nnue
@@ -0,0 +1,40 @@
+#ifndef NNUE_SIMD_H
+#define NNUE_SIMD_H
+
+#include <cstdint>
+
+// Inner loops of the network evaluation with scalar, SSE4.1 and AVX2
+// implementations. The backend is picked at startup from CPUID; all of them
+// produce bit-identical results.
+
+namespace nnue {
+
+enum class SimdBackend {
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+struct Kernels {
+    // values[i] += weights[i] / values[i] -= weights[i] (int16 wraparound), size % 16 == 0
+    void (*addWeights)(int16_t* values, const int16_t* weights, int size);
+    void (*subWeights)(int16_t* values, const int16_t* weights, int size);
+    // output[i] = clamp(input[i], 0, 127), size % 32 == 0
+    void (*clippedRelu)(const int16_t* input, uint8_t* output, int size);
+    // sum of input[i] * weights[i], inputs must be <= 127, size % 32 == 0
+    int32_t (*dotProduct)(const uint8_t* input, const int8_t* weights, int size);
+};
+
+const Kernels& kernels();
+
+bool setSimdBackend(SimdBackend backend); // false if the CPU lacks it
+SimdBackend getSimdBackend();
+bool cpuSupports(SimdBackend backend);
+const char* simdBackendName(SimdBackend backend);
+
+// direct access for tests and benchmarks, regardless of the active backend
+const Kernels& kernelsFor(SimdBackend backend);
+
+} // namespace nnue
+
+#endif // NNUE_SIMD_H
@@ -0,0 +1,169 @@
+#include "batch.h"
+#include "board.h"
+#include "movetables.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+// Converts between FEN/EPD text and the 32-byte PackedPosition format
+// (raw records, no header):
+//   packconvert pack positions.fen positions.bin
+//   packconvert unpack positions.bin positions.fen
+//   packconvert bench positions.fen      parse vs decode speed and sizes
+
+void printUsage() {
+    cerr << "usage: packconvert pack <in.fen> <out.bin>" << endl;
+    cerr << "       packconvert unpack <in.bin> <out.fen>" << endl;
+    cerr << "       packconvert bench <in.fen>" << endl;
+}
+
+double perSecond(size_t count, steady_clock::duration elapsed) {
+    double seconds = duration_cast<microseconds>(elapsed).count() / 1e6;
+    return seconds > 0 ? count / seconds : 0.0;
+}
+
+bool readLines(const string& path, vector<string>& lines, size_t& bytes) {
+    ifstream in(path);
+    if (!in) return false;
+    string line;
+    bytes = 0;
+    while (getline(in, line)) {
+        bytes += line.size() + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        lines.push_back(line);
+    }
+    return true;
+}
+
+// FEN lines -> packed records; unparsable lines are skipped and counted
+vector<PackedPosition> packLines(const vector<string>& lines, size_t& skipped) {
+    vector<PackedPosition> packed;
+    packed.reserve(lines.size());
+    skipped = 0;
+    Board board;
+    for (const string& line : lines) {
+        if (!board.setFen(line)) {
+            ++skipped;
+            continue;
+        }
+        packed.push_back(board.encode());
+    }
+    return packed;
+}
+
+int pack(const string& inPath, const string& outPath) {
+    vector<string> lines;
+    size_t textBytes = 0;
+    if (!readLines(inPath, lines, textBytes)) {
+        cerr << "could not read " << inPath << endl;
+        return 1;
+    }
+
+    auto start = steady_clock::now();
+    size_t skipped = 0;
+    vector<PackedPosition> packed = packLines(lines, skipped);
+    auto elapsed = steady_clock::now() - start;
+
+    ofstream out(outPath, ios::binary);
+    out.write(reinterpret_cast<const char*>(packed.data()), packed.size() * sizeof(PackedPosition));
+    if (!out) {
+        cerr << "could not write " << outPath << endl;
+        return 1;
+    }
+
+    size_t packedBytes = packed.size() * sizeof(PackedPosition);
+    cerr << packed.size() << " positions packed (" << skipped << " skipped), "
+         << textBytes << " -> " << packedBytes << " bytes ("
+         << (packedBytes ? static_cast<double>(textBytes) / packedBytes : 0.0) << "x smaller), "
+         << static_cast<long long>(perSecond(lines.size(), elapsed)) << " positions/s" << endl;
+    return 0;
+}
+
+int unpack(const string& inPath, const string& outPath) {
+    vector<PackedPosition> packed;
+    if (!batch::readPackedFile(inPath, packed)) {
+        cerr << "could not read " << inPath << " as packed positions" << endl;
+        return 1;
+    }
+
+    ofstream out(outPath);
+    if (!out) {
+        cerr << "could not write " << outPath << endl;
+        return 1;
+    }
+
+    auto start = steady_clock::now();
+    Board board;
+    char fen[Board::FEN_BUFFER_SIZE];
+    size_t invalid = 0;
+    for (const PackedPosition& position : packed) {
+        if (!board.decode(position)) {
+            ++invalid;
+            continue;
+        }
+        size_t length = board.writeFen(fen);
+        fen[length] = '\n';
+        out.write(fen, length + 1);
+    }
+    auto elapsed = steady_clock::now() - start;
+
+    cerr << packed.size() - invalid << " positions unpacked (" << invalid << " invalid), "
+         << static_cast<long long>(perSecond(packed.size(), elapsed)) << " positions/s" << endl;
+    return 0;
+}
+
+int bench(const string& inPath) {
+    vector<string> lines;
+    size_t textBytes = 0;
+    if (!readLines(inPath, lines, textBytes)) {
+        cerr << "could not read " << inPath << endl;
+        return 1;
+    }
+    size_t skipped = 0;
+    vector<PackedPosition> packed = packLines(lines, skipped);
+
+    Board board;
+    U64 checksum = 0;
+    auto start = steady_clock::now();
+    for (const string& line : lines) {
+        board.setFen(line);
+        checksum ^= board.hash;
+    }
+    auto parseTime = steady_clock::now() - start;
+
+    start = steady_clock::now();
+    for (const PackedPosition& position : packed) {
+        board.decode(position);
+        checksum ^= board.hash;
+    }
+    auto decodeTime = steady_clock::now() - start;
+
+    double parseRate = perSecond(lines.size(), parseTime);
+    double decodeRate = perSecond(packed.size(), decodeTime);
+    cerr << lines.size() << " positions, " << textBytes << " bytes as text, "
+         << packed.size() * sizeof(PackedPosition) << " bytes packed" << endl;
+    cerr << "FEN parse: " << static_cast<long long>(parseRate) << " positions/s" << endl;
+    cerr << "decode:    " << static_cast<long long>(decodeRate) << " positions/s ("
+         << (parseRate > 0 ? decodeRate / parseRate : 0.0) << "x)" << endl;
+    cerr << "checksum " << checksum << endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    MoveTables::instance().init();
+
+    if (argc == 4 && string(argv[1]) == "pack") return pack(argv[2], argv[3]);
+    if (argc == 4 && string(argv[1]) == "unpack") return unpack(argv[2], argv[3]);
+    if (argc == 3 && string(argv[1]) == "bench") return bench(argv[2]);
+
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,165 @@
+#include "pawns.h"
+#include "evaluation.h"
+
+namespace pawns {
+
+namespace {
+
+const U64 FILE_A = 0x0101010101010101ULL;
+
+inline U64 fileMask(int file) {
+    return FILE_A << file;
+}
+
+inline U64 adjacentFilesMask(int file) {
+    U64 mask = 0ULL;
+    if (file > 0) mask |= fileMask(file - 1);
+    if (file < 7) mask |= fileMask(file + 1);
+    return mask;
+}
+
+// all squares strictly in front of the rank of square, from the side's point of view
+inline U64 forwardRanks(int square, bool white) {
+    int rank = square / 8;
+    if (white) return (rank == 7) ? 0ULL : (~0ULL << (8 * (rank + 1)));
+    return (rank == 0) ? 0ULL : (~0ULL >> (8 * (8 - rank)));
+}
+
+// squares on the same rank and behind, from the side's point of view
+inline U64 rankAndBehind(int square, bool white) {
+    return ~forwardRanks(square, white);
+}
+
+void evaluateSide(const Board& board, bool white, PawnEntry& entry, int& mg, int& eg, PawnTrace* trace) {
+    const evaluation::EvalParams& params = evaluation::params();
+    U64 own = board.pieceBB[nPawns] & board.pieceBB[white ? nWhite : nBlack];
+    U64 enemy = board.pieceBB[nPawns] & board.pieceBB[white ? nBlack : nWhite];
+    enumPiece side = white ? nWhite : nBlack;
+
+    // enemy pawn attacks, used for backward pawns
+    U64 enemyAttacks = white
+        ? (((enemy & ~fileMask(0)) >> 9) | ((enemy & ~fileMask(7)) >> 7))
+        : (((enemy & ~fileMask(0)) << 7) | ((enemy & ~fileMask(7)) << 9));
+
+    U64 pawnsLeft = own;
+    while (pawnsLeft) {
+        int square = __builtin_ctzll(pawnsLeft);
+        pawnsLeft &= pawnsLeft - 1;
+
+        int file = square % 8;
+        int relativeRank = white ? square / 8 : 7 - square / 8;
+        U64 front = forwardRanks(square, white);
+        U64 neighbours = adjacentFilesMask(file);
+
+        entry.attackSpans[side] |= front & neighbours;
+
+        // doubled: another own pawn ahead on the same file (count each extra pawn once)
+        if (own & fileMask(file) & front) {
+            mg += params.doubledMg;
+            eg += params.doubledEg;
+            if (trace) trace->doubled[side]++;
+        }
+
+        bool isolated = !(own & neighbours);
+        if (isolated) {
+            mg += params.isolatedMg;
+            eg += params.isolatedEg;
+            if (trace) trace->isolated[side]++;
+        }
+
+        // passed: no enemy pawn ahead on this or the adjacent files
+        if (!(enemy & front & (fileMask(file) | neighbours))) {
+            entry.passedPawns[side] |= 1ULL << square;
+            mg += params.passedMg[relativeRank];
+            eg += params.passedEg[relativeRank];
+            if (trace) trace->passed[side][relativeRank]++;
+        } else if (!isolated) {
+            // backward: every neighbour is ahead of it and the stop square is controlled by enemy pawns
+            int stop = white ? square + 8 : square - 8;
+            bool supported = own & neighbours & rankAndBehind(square, white);
+            if (!supported && (enemyAttacks & (1ULL << stop))) {
+                mg += params.backwardMg;
+                eg += params.backwardEg;
+                if (trace) trace->backward[side]++;
+            }
+        }
+    }
+}
+
+} // namespace
+
+PawnHashTable::PawnHashTable(size_t numEntries) : entries(numEntries), mask(numEntries - 1) {
+    clear();
+}
+
+void PawnHashTable::clear() {
+    // key 0 is the empty pawn structure, so mark slots empty with a key that
+    // cannot match the entry's index
+    for (size_t i = 0; i < entries.size(); ++i) {
+        entries[i] = PawnEntry();
+        entries[i].key = ~static_cast<U64>(i);
+    }
+}
+
+const PawnEntry& PawnHashTable::probe(const Board& board) {
+    ++probes;
+    U64 key = board.pawnHash;
+    PawnEntry& entry = entries[key & mask];
+    if (entry.key == key) {
+        ++hits;
+        return entry;
+    }
+
+    evaluatePawns(board, entry);
+    entry.key = key;
+    return entry;
+}
+
+PawnHashTable& threadTable() {
+    thread_local PawnHashTable table;
+    return table;
+}
+
+void evaluatePawns(const Board& board, PawnEntry& entry, PawnTrace* trace) {
+    entry.passedPawns[nWhite] = entry.passedPawns[nBlack] = 0ULL;
+    entry.attackSpans[nWhite] = entry.attackSpans[nBlack] = 0ULL;
+
+    int whiteMg = 0, whiteEg = 0, blackMg = 0, blackEg = 0;
+    evaluateSide(board, true, entry, whiteMg, whiteEg, trace);
+    evaluateSide(board, false, entry, blackMg, blackEg, trace);
+
+    entry.mg = whiteMg - blackMg;
+    entry.eg = whiteEg - blackEg;
+}
+
+int kingShield(const Board& board, PawnTrace* trace) {
+    int score = 0;
+    for (int colour = nBlack; colour <= nWhite; ++colour) {
+        bool white = (colour == nWhite);
+        U64 king = board.pieceBB[nKings] & board.pieceBB[colour];
+        if (!king) continue;
+
+        int kingSquare = __builtin_ctzll(king);
+        int file = kingSquare % 8;
+        U64 files = fileMask(file) | adjacentFilesMask(file);
+        U64 own = board.pieceBB[nPawns] & board.pieceBB[colour];
+
+        U64 near = white ? (king << 8) : (king >> 8);
+        U64 far = white ? (king << 16) : (king >> 16);
+        // widen to the neighbouring files on those ranks
+        U64 nearRank = near ? (0xFFULL << (8 * (__builtin_ctzll(near) / 8))) : 0ULL;
+        U64 farRank = far ? (0xFFULL << (8 * (__builtin_ctzll(far) / 8))) : 0ULL;
+
+        int nearCount = __builtin_popcountll(own & files & nearRank);
+        int farCount = __builtin_popcountll(own & files & farRank);
+        if (trace) {
+            trace->shieldNear[colour] += nearCount;
+            trace->shieldFar[colour] += farCount;
+        }
+        int shield = nearCount * evaluation::params().shieldNear + farCount * evaluation::params().shieldFar;
+        score += white ? shield : -shield;
+    }
+    return score;
+}
+
+} // namespace pawns
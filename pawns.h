@@ -0,0 +1,83 @@
+#ifndef PAWNS_H
+#define PAWNS_H
+
+#include "board.h"
+#include "types.h"
+
+#include <cstddef>
+#include <vector>
+
+// Pawn-structure evaluation backed by a per-thread pawn hash table.
+// Pawn structure changes rarely, so the terms below are computed once per
+// pawn key (Board::pawnHash) and reused until the pawns move.
+
+namespace pawns {
+
+// default penalties/bonuses in centipawns (middlegame, endgame), the values in
+// use come from evaluation::params()
+const int DOUBLED_MG = -10;
+const int DOUBLED_EG = -20;
+const int ISOLATED_MG = -10;
+const int ISOLATED_EG = -15;
+const int BACKWARD_MG = -8;
+const int BACKWARD_EG = -10;
+
+// passed pawn bonus by rank relative to the pawn's own side (0 = first rank)
+const int PASSED_MG[8] = {0, 5, 10, 15, 25, 40, 60, 0};
+const int PASSED_EG[8] = {0, 10, 15, 25, 45, 70, 110, 0};
+
+// middlegame bonus per own pawn directly in front of the king / one rank further
+const int SHIELD_NEAR = 10;
+const int SHIELD_FAR = 5;
+
+struct PawnEntry {
+    U64 key;
+    int mg;                 // white perspective
+    int eg;
+    U64 passedPawns[2];     // indexed by nBlack / nWhite
+    U64 attackSpans[2];     // every square the side's pawns could ever attack
+};
+
+// how often each term fired per side (indexed by nBlack / nWhite), for the tuner
+struct PawnTrace {
+    int doubled[2] = {};
+    int isolated[2] = {};
+    int backward[2] = {};
+    int passed[2][8] = {};      // by relative rank
+    int shieldNear[2] = {};
+    int shieldFar[2] = {};
+};
+
+class PawnHashTable {
+public:
+    static const size_t DEFAULT_ENTRIES = 16384; // power of two
+
+    explicit PawnHashTable(size_t numEntries = DEFAULT_ENTRIES);
+
+    // returns the cached entry for the board's pawn key, computing it on a miss
+    const PawnEntry& probe(const Board& board);
+    void clear();
+
+    void resetStats() { probes = 0; hits = 0; }
+    long getProbes() const { return probes; }
+    long getHits() const { return hits; }
+
+private:
+    std::vector<PawnEntry> entries;
+    size_t mask;
+    long probes = 0;
+    long hits = 0;
+};
+
+// the calling thread's table
+PawnHashTable& threadTable();
+
+// uncached pawn-structure evaluation, fills everything except the key
+void evaluatePawns(const Board& board, PawnEntry& entry, PawnTrace* trace = nullptr);
+
+// king shelter from own pawns in front of the king (middlegame only, white perspective)
+int kingShield(const Board& board, PawnTrace* trace = nullptr);
+
+} // namespace pawns
+
+#endif // PAWNS_H
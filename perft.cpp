@@ -1,10 +1,18 @@
+#include "bitboard.h"
 #include "board.h"
 #include "game.h"
 #include "move.h"
+#include "movetables.h"
+#include "nnue.h"
+#include "nnue_simd.h"
+#include "transposition.h"
 
 #include <iostream>
 #include <cassert>
+#include <chrono>
 #include <iomanip>
+#include <memory>
+#include <random>
 
 using namespace std;
 using namespace std::chrono;
@@ -70,6 +78,7 @@ void verifyStandard() {
     vector<Test> tests = {
         {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609},
         {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -", 4, 4085603},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624},
     };
     
     for (auto& test : tests) {
@@ -81,9 +90,177 @@ void verifyStandard() {
     }
 }
 
+// cost of everything a short-lived engine process does before it can search
+void benchStartup() {
+    auto start = high_resolution_clock::now();
+    MoveTables::instance().init();
+    Game game;
+    auto tablesDone = high_resolution_clock::now();
+
+    TranspositionTable tt(64);
+    auto ttDone = high_resolution_clock::now();
+
+    cout << "\nstartup benchmark" << endl;
+    cout << "=====================================" << endl;
+    cout << "tables + game: " << duration_cast<microseconds>(tablesDone - start).count() << "us" << endl;
+    cout << "64MB hash: " << duration_cast<microseconds>(ttDone - tablesDone).count() << "us" << endl;
+    cout << "slider backend: " << MagicBitboard::backendName(MagicBitboard::instance().getBackend()) << endl;
+}
+
+// times the same perft runs with each slider lookup implementation
+void benchSliderBackends() {
+    struct Bench { string fen; int depth; };
+    vector<Bench> benches = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4},
+    };
+
+    MagicBitboard& magic = MagicBitboard::instance();
+    SliderBackend original = magic.getBackend();
+
+    cout << "\nslider backend benchmark" << endl;
+    cout << "=====================================" << endl;
+    for (SliderBackend backend : {SliderBackend::Magic, SliderBackend::Pext}) {
+        if (!magic.setBackend(backend)) {
+            cout << MagicBitboard::backendName(backend) << ": not supported on this CPU" << endl;
+            continue;
+        }
+
+        long long totalNodes = 0;
+        auto start = high_resolution_clock::now();
+        for (auto& bench : benches) {
+            Game game(bench.fen);
+            game.enableFastMode();
+            totalNodes += perft(game, bench.depth);
+        }
+        auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+
+        cout << MagicBitboard::backendName(backend) << ": " << totalNodes << " nodes in "
+             << duration.count() << "ms (" << fixed << setprecision(0)
+             << (totalNodes * 1000.0) / std::max<long long>(1, duration.count()) << " nps)" << endl;
+    }
+    magic.setBackend(original);
+}
+
+// network evaluation throughput per kernel backend, on random weights: a full
+// accumulator refresh per position and the incremental push/evaluate/pop cycle
+void benchNetworkBackends() {
+    std::mt19937 rng(12345);
+    std::unique_ptr<nnue::Network> net(new nnue::Network());
+    for (int16_t& w : net->featureWeights) w = static_cast<int16_t>(static_cast<int>(rng() % 65) - 32);
+    for (int8_t& w : net->l1Weights) w = static_cast<int8_t>(rng());
+    for (int8_t& w : net->outputWeights) w = static_cast<int8_t>(rng());
+    nnue::setNetwork(std::move(net));
+    nnue::setEnabled(true);
+
+    const int iterations = 20000;
+    nnue::SimdBackend original = nnue::getSimdBackend();
+    Game game("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    game.enableFastMode();
+    MovesStruct moves = game.generateAllLegalMoves();
+
+    cout << "\nnetwork kernel benchmark" << endl;
+    cout << "=====================================" << endl;
+    for (nnue::SimdBackend backend : {nnue::SimdBackend::Scalar, nnue::SimdBackend::SSE41, nnue::SimdBackend::AVX2}) {
+        if (!nnue::setSimdBackend(backend)) {
+            cout << nnue::simdBackendName(backend) << ": not supported on this CPU" << endl;
+            continue;
+        }
+
+        long long checksum = 0;
+        auto start = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            nnue::Accumulator acc;
+            checksum += nnue::evaluate(game.board, acc);
+        }
+        auto refreshTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+        nnue::evaluate(game.board, game.currentAccumulator());
+        start = high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            game.pushMove(moves.getMove(i % moves.getNumMoves()));
+            checksum += nnue::evaluate(game.board, game.currentAccumulator());
+            game.popMove();
+        }
+        auto incrementalTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+        cout << nnue::simdBackendName(backend) << ": " << fixed << setprecision(0)
+             << iterations * 1e6 / std::max<long long>(1, refreshTime) << " refresh evals/s, "
+             << iterations * 1e6 / std::max<long long>(1, incrementalTime) << " incremental evals/s"
+             << " (checksum " << checksum << ")" << endl;
+    }
+
+    nnue::setSimdBackend(original);
+    nnue::setEnabled(false);
+    nnue::setNetwork(nullptr);
+}
+
+// FEN parse/serialise and packed decode throughput over positions collected from random games
+void benchFen() {
+    std::mt19937 rng(2024);
+    vector<string> corpus;
+    corpus.reserve(100000);
+    while (corpus.size() < 100000) {
+        Game game;
+        for (int ply = 0; ply < 120 && corpus.size() < 100000; ++ply) {
+            MovesStruct moves = game.generateAllLegalMoves();
+            if (moves.getNumMoves() == 0) break;
+            game.pushMove(moves.getMove(rng() % moves.getNumMoves()));
+            corpus.push_back(game.board.toString());
+        }
+    }
+
+    Board board;
+    U64 checksum = 0;
+    auto start = high_resolution_clock::now();
+    for (const string& fen : corpus) {
+        board.setFen(fen);
+        checksum ^= board.hash;
+    }
+    auto parseTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    char buffer[Board::FEN_BUFFER_SIZE];
+    size_t totalLength = 0;
+    start = high_resolution_clock::now();
+    for (const string& fen : corpus) {
+        board.setFen(fen);
+        totalLength += board.writeFen(buffer);
+    }
+    auto roundTripTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    vector<PackedPosition> packed;
+    packed.reserve(corpus.size());
+    size_t textBytes = 0;
+    for (const string& fen : corpus) {
+        board.setFen(fen);
+        packed.push_back(board.encode());
+        textBytes += fen.size() + 1;
+    }
+    start = high_resolution_clock::now();
+    for (const PackedPosition& position : packed) {
+        board.decode(position);
+        checksum ^= board.hash;
+    }
+    auto decodeTime = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    cout << "\nFEN benchmark (" << corpus.size() << " positions)" << endl;
+    cout << "=====================================" << endl;
+    cout << "parse: " << fixed << setprecision(0) << corpus.size() * 1e6 / std::max<long long>(1, parseTime) << " FENs/s" << endl;
+    cout << "parse + write: " << corpus.size() * 1e6 / std::max<long long>(1, roundTripTime) << " FENs/s"
+         << " (checksum " << (checksum ^ totalLength) << ")" << endl;
+    cout << "packed decode: " << corpus.size() * 1e6 / std::max<long long>(1, decodeTime) << " positions/s"
+         << " (" << setprecision(1) << static_cast<double>(parseTime) / std::max<long long>(1, decodeTime) << "x parse)" << endl;
+    cout << "size: " << textBytes << " bytes as FEN lines, " << packed.size() * sizeof(PackedPosition) << " bytes packed ("
+         << static_cast<double>(textBytes) / (packed.size() * sizeof(PackedPosition)) << "x smaller)" << endl;
+}
+
 
 int main() {   
+    benchStartup();
     verifyStandard();
+    benchSliderBackends();
+    benchNetworkBackends();
+    benchFen();
 
     Game game("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
     // Game game("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
@@ -1,32 +1,131 @@
 #include "search.h"
 #include "transposition.h"
+#include "pawns.h"
 #include <chrono>
+#include <cmath>
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cstring>
 #include <sstream>
 #include <unordered_set>
 #include <atomic>
 
 using namespace std;
 
-std::chrono::steady_clock::time_point g_searchStartTime;
-long g_timeLimit = 20000;  // ms
-
-long g_nodeLimit = -1;
-long g_nodeCount = 0;
-long g_ttHits = 0;
-long g_ttProbes = 0;
-
-bool g_timeoutOccurred = false;
-Move killerMoves[MAX_SEARCH_DEPTH][2];
+thread_local std::chrono::steady_clock::time_point g_searchStartTime;
+thread_local long g_timeLimit = 20000;  // ms
+
+thread_local long g_nodeLimit = -1;
+thread_local long g_nodeCount = 0;
+thread_local long g_ttHits = 0;
+thread_local long g_ttProbes = 0;
+thread_local long g_pvNodes = 0;
+thread_local long g_pvsResearches = 0;
+thread_local long g_aspirationFailLows = 0;
+thread_local long g_aspirationFailHighs = 0;
+thread_local long g_nullMoveTries = 0;
+thread_local long g_nullMoveCutoffs = 0;
+thread_local long g_lmrReductions = 0;
+thread_local long g_lmrResearches = 0;
+thread_local long g_reverseFutilityCutoffs = 0;
+thread_local long g_razorTries = 0;
+thread_local long g_razorCutoffs = 0;
+thread_local long g_futilityPrunes = 0;
+thread_local long g_betaCutoffs = 0;
+thread_local long g_firstMoveCutoffs = 0;
+thread_local long g_qsearchNodes = 0;
+thread_local long g_qsearchHistoryPrunes = 0;
+thread_local long g_qsearchSeePrunes = 0;
+
+thread_local bool g_timeoutOccurred = false;
+thread_local Move killerMoves[MAX_SEARCH_DEPTH][2];
+thread_local int g_history[2][64][64];
+thread_local Move g_counterMoves[12][64];
+thread_local SearchStackEntry g_searchStack[MAX_SEARCH_PLY];
+thread_local int g_captureHistory[12][64][6];
+
+ContinuationHistory& threadContinuationHistory() {
+    thread_local ContinuationHistory table;
+    return table;
+}
 std::atomic<bool> g_stopRequested(false);
 
-std::vector<std::string> g_searchTree;
-int g_currentPly = 0;
-bool g_recordSearchTree = false;
+thread_local std::vector<std::string> g_searchTree;
+thread_local int g_currentPly = 0;
+thread_local bool g_recordSearchTree = false;
 size_t g_searchTreeMaxLines = 200000;
 
+int g_lmrBase = 75;
+int g_lmrDivisor = 225;
+int g_lmrMinDepth = 3;
+int g_lmrMinMoves = 3;
+int g_lmrHistoryDivisor = 16384;
+int g_qsHistoryPrune = 2048;
+int g_rfpMaxDepth = 6;
+int g_rfpMargin = 80;
+int g_razorMaxDepth = 3;
+int g_razorBase = 200;
+int g_razorMargin = 150;
+int g_futilityMaxDepth = 6;
+int g_futilityBase = 100;
+int g_futilityMargin = 100;
+
+static int g_lmrTable[MAX_SEARCH_DEPTH + 1][LMR_TABLE_MOVES];
+
+void initReductions() {
+    const double divisor = std::max(g_lmrDivisor, 1) / 100.0;
+    for (int depth = 0; depth <= MAX_SEARCH_DEPTH; ++depth) {
+        for (int moveNumber = 0; moveNumber < LMR_TABLE_MOVES; ++moveNumber) {
+            g_lmrTable[depth][moveNumber] = (depth == 0 || moveNumber == 0) ? 0 :
+                static_cast<int>(g_lmrBase / 100.0 + std::log(depth) * std::log(moveNumber) / divisor);
+        }
+    }
+}
+
+int lmrReduction(int depth, int moveNumber) {
+    return g_lmrTable[std::min(depth, MAX_SEARCH_DEPTH)][std::min(moveNumber, LMR_TABLE_MOVES - 1)];
+}
+
+// the table is valid from startup and rebuilt whenever a parameter changes
+static const bool g_reductionsReady = (initReductions(), true);
+
+const std::vector<SearchTunable>& searchTunables() {
+    static const std::vector<SearchTunable> tunables = {
+        {"LmrBase", &g_lmrBase, 75, 0, 300},
+        {"LmrDivisor", &g_lmrDivisor, 225, 50, 600},
+        {"LmrMinDepth", &g_lmrMinDepth, 3, 1, 10},
+        {"LmrMinMoves", &g_lmrMinMoves, 3, 1, 20},
+        {"LmrHistoryDivisor", &g_lmrHistoryDivisor, 16384, 1024, 65536},
+        {"QsHistoryPrune", &g_qsHistoryPrune, 2048, 0, HISTORY_MAX},
+        {"RfpMaxDepth", &g_rfpMaxDepth, 6, 0, 12},
+        {"RfpMargin", &g_rfpMargin, 80, 0, 500},
+        {"RazorMaxDepth", &g_razorMaxDepth, 3, 0, 6},
+        {"RazorBase", &g_razorBase, 200, 0, 1000},
+        {"RazorMargin", &g_razorMargin, 150, 0, 1000},
+        {"FutilityMaxDepth", &g_futilityMaxDepth, 6, 0, 12},
+        {"FutilityBase", &g_futilityBase, 100, 0, 1000},
+        {"FutilityMargin", &g_futilityMargin, 100, 0, 500},
+    };
+    return tunables;
+}
+
+bool setSearchTunable(const std::string& name, int value) {
+    for (const SearchTunable& tunable : searchTunables()) {
+        if (name != tunable.name) continue;
+        *tunable.value = std::clamp(value, tunable.min, tunable.max);
+        initReductions();
+        return true;
+    }
+    return false;
+}
+
+// king and pawns only is where zugzwang is common enough that passing
+// overestimates the position
+static inline bool hasNonPawnMaterial(const Board& board) {
+    return board.getFriendlyPieces() & ~(board.pieceBB[nPawns] | board.pieceBB[nKings]);
+}
+
 static inline int getPlyFromRoot() {
     return g_currentPly > 0 ? g_currentPly : 0; // Ensure we don't return negative ply
 }
@@ -56,7 +155,9 @@ void recordEntry(const Game& game, int depth, int alpha, int beta) {
             << " a=" << alpha << " b=" << beta
             << " hash=0x" << std::hex << game.board.getHash() << std::dec;
         // try to append a short FEN (if available) - keep it short to avoid massive lines
-        oss << " fen=" << game.board.toString();
+        char fen[Board::FEN_BUFFER_SIZE];
+        game.board.writeFen(fen);
+        oss << " fen=" << fen;
         g_searchTree.push_back(oss.str());
     }
     ++g_currentPly;
@@ -120,20 +221,75 @@ void resetSearchStats() {
     g_nodeCount = 0;
     g_ttHits = 0;
     g_ttProbes = 0;
+    g_pvNodes = 0;
+    g_pvsResearches = 0;
+    g_aspirationFailLows = 0;
+    g_aspirationFailHighs = 0;
+    g_nullMoveTries = 0;
+    g_nullMoveCutoffs = 0;
+    g_lmrReductions = 0;
+    g_lmrResearches = 0;
+    g_reverseFutilityCutoffs = 0;
+    g_razorTries = 0;
+    g_razorCutoffs = 0;
+    g_futilityPrunes = 0;
+    g_betaCutoffs = 0;
+    g_firstMoveCutoffs = 0;
+    g_qsearchNodes = 0;
+    g_qsearchHistoryPrunes = 0;
+    g_qsearchSeePrunes = 0;
     g_timeoutOccurred = false;
+    pawns::threadTable().resetStats();
+    threadEvalCache().resetStats();
 
     for (int depth = 0; depth < MAX_SEARCH_DEPTH; ++depth) {
         killerMoves[depth][0] =MOVE_NONE;
         killerMoves[depth][1] =MOVE_NONE;
     }
+    std::memset(g_history, 0, sizeof(g_history));
+    std::memset(g_captureHistory, 0, sizeof(g_captureHistory));
+    std::fill(&g_counterMoves[0][0], &g_counterMoves[0][0] + 12 * 64, MOVE_NONE);
+    threadContinuationHistory().clear();
 }
 
 void printSearchStats() {
     if (g_ttProbes > 0) {
         double hitRate = (double)g_ttHits / g_ttProbes * 100.0;
-        string output = "STATS: Nodes=" + to_string(g_nodeCount) +
+        string output = "STATS: Nodes=" + to_string(g_nodeCount) + " QNodes=" + to_string(g_qsearchNodes) +
+                        " QHistPrune=" + to_string(g_qsearchHistoryPrunes) +
+                        " QSeePrune=" + to_string(g_qsearchSeePrunes) +
                         " TT=" + to_string(g_ttHits) + "/" + to_string(g_ttProbes) +
-                        " (" + to_string(hitRate) + "%)";
+                        " (" + to_string(hitRate) + "%)" +
+                        " PV=" + to_string(g_pvNodes) + " Researches=" + to_string(g_pvsResearches) +
+                        " AspFail=" + to_string(g_aspirationFailLows) + "/" + to_string(g_aspirationFailHighs) +
+                        " Null=" + to_string(g_nullMoveCutoffs) + "/" + to_string(g_nullMoveTries) +
+                        " LMR=" + to_string(g_lmrReductions) + "/" + to_string(g_lmrResearches) +
+                        " RFP=" + to_string(g_reverseFutilityCutoffs) +
+                        " Razor=" + to_string(g_razorCutoffs) + "/" + to_string(g_razorTries) +
+                        " Futility=" + to_string(g_futilityPrunes);
+        if (g_betaCutoffs > 0) {
+            output += " FirstCut=" + to_string(g_firstMoveCutoffs) + "/" + to_string(g_betaCutoffs) +
+                      " (" + to_string((double)g_firstMoveCutoffs / g_betaCutoffs * 100.0) + "%)";
+        }
+
+        const pawns::PawnHashTable& pawnTable = pawns::threadTable();
+        if (pawnTable.getProbes() > 0) {
+            double pawnHitRate = (double)pawnTable.getHits() / pawnTable.getProbes() * 100.0;
+            output += " PawnTT=" + to_string(pawnTable.getHits()) + "/" + to_string(pawnTable.getProbes()) +
+                      " (" + to_string(pawnHitRate) + "%)";
+        }
+
+        const EvalCache& evalCache = threadEvalCache();
+        long evalProbes = evalCache.getHits() + evalCache.getMisses();
+        if (evalProbes > 0) {
+            double evalHitRate = (double)evalCache.getHits() / evalProbes * 100.0;
+            output += " EvalCache=" + to_string(evalCache.getHits()) + "/" + to_string(evalProbes) +
+                      " (" + to_string(evalHitRate) + "%)";
+        }
+
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - g_searchStartTime).count();
+        output += " Time=" + to_string(elapsedMs) + "ms NPS=" + to_string(g_nodeCount * 1000 / std::max<long>(1, elapsedMs));
         std::cerr << output << std::endl;
     }
 }
@@ -166,8 +322,10 @@ int getTerminalValue(Game& game) {
     return 0;
 }
 
-int alphabeta(int alpha, int beta, int depth, Game& game){
+int alphabeta(int alpha, int beta, int depth, Game& game, NodeType nodeType){
+    TranspositionTable& tt = threadTranspositionTable();
     g_nodeCount++;
+    if (nodeType == PV_NODE) g_pvNodes++;
     recordEntry(game, depth, alpha, beta);
 
     if (g_nodeCount % 1024 == 0 && isTimeUp()) {
@@ -184,7 +342,7 @@ int alphabeta(int alpha, int beta, int depth, Game& game){
         int ttScore;
         g_ttProbes++;
 
-        if (g_transpositionTable.probe(hash, alpha, beta, depth, ttScore)) {
+        if (tt.probe(hash, alpha, beta, depth, ttScore)) {
             g_ttHits++;
             int ret = adjustMateScore(ttScore, getPlyFromRoot());
             recordExit(game, depth, ret);
@@ -192,13 +350,13 @@ int alphabeta(int alpha, int beta, int depth, Game& game){
         }
     }
 
-    ttBestMove = g_transpositionTable.getBestMove(hash);
+    ttBestMove = tt.getBestMove(hash);
 
     if (game.isPositionTerminal()) {
         int score = getTerminalValue(game);
         if (depth > 0) {
             int adjustedScore = adjustMateScore(score, getPlyFromRoot());
-            g_transpositionTable.store(hash, adjustedScore, depth, TT_EXACT, MOVE_NONE);
+            tt.store(hash, adjustedScore, depth, TT_EXACT, MOVE_NONE);
         }
         recordExit(game, depth, score);
         return score;
@@ -216,6 +374,66 @@ int alphabeta(int alpha, int beta, int depth, Game& game){
         return STALEMATE_VALUE;
     }
 
+    if (getPlyFromRoot() >= MAX_SEARCH_PLY) {
+        int score = evalForSide(game);
+        recordExit(game, depth, score);
+        return score;
+    }
+
+    const bool inCheck = game.isInCheck();
+
+    // the static eval drives every pruning decision below, none of which
+    // applies in check, at PV nodes or with a mate score in the window
+    const bool pruningNode = nodeType == NON_PV_NODE && !inCheck &&
+                             std::abs(alpha) < MATE_THRESHOLD && std::abs(beta) < MATE_THRESHOLD;
+    int staticEval = STATIC_EVAL_NONE;
+    if (pruningNode) {
+        staticEval = tt.getStaticEval(hash);
+        if (staticEval == STATIC_EVAL_NONE) staticEval = evalForSide(game);
+    }
+
+    // reverse futility: far enough above beta that no reply at this depth
+    // is expected to bring it back
+    if (pruningNode && depth <= g_rfpMaxDepth && staticEval - g_rfpMargin * depth >= beta) {
+        g_reverseFutilityCutoffs++;
+        recordExit(game, depth, staticEval);
+        return staticEval;
+    }
+
+    // razoring: far below alpha, only captures can help, so ask qsearch
+    if (pruningNode && depth <= g_razorMaxDepth && staticEval + g_razorBase + g_razorMargin * depth < alpha) {
+        g_razorTries++;
+        int score = quiescenceSearch(alpha, beta, game, 0);
+        if (score <= alpha) {
+            g_razorCutoffs++;
+            recordExit(game, depth, score);
+            return score;
+        }
+    }
+
+    // null-move pruning: if passing still fails high on a reduced search, some
+    // real move almost certainly does too. Never twice in a row or without
+    // pieces to move
+    if (pruningNode && depth >= NULL_MOVE_MIN_DEPTH && game.lastMove() != MOVE_NONE &&
+        hasNonPawnMaterial(game.board)) {
+        if (staticEval >= beta) {
+            int reduction = NULL_MOVE_BASE_REDUCTION + depth / NULL_MOVE_DEPTH_DIVISOR +
+                            std::min((staticEval - beta) / 200, 3);
+            g_nullMoveTries++;
+            g_searchStack[getPlyFromRoot()] = {MOVE_NONE, -1};
+            game.pushNullMove();
+            int score = -alphabeta(-beta, -beta + 1, depth - 1 - reduction, game, NON_PV_NODE);
+            game.popNullMove();
+
+            if (score >= beta && !isTimeUp()) {
+                g_nullMoveCutoffs++;
+                if (score >= MATE_THRESHOLD) score = beta; // an unproven mate
+                recordExit(game, depth, score);
+                return score;
+            }
+        }
+    }
+
     // Generate legal moves
     MovesStruct legalMoves = game.generateAllLegalMoves();
 
@@ -225,7 +443,7 @@ int alphabeta(int alpha, int beta, int depth, Game& game){
 
         if (depth > 0) {
             int adjustedScore = adjustMateScore(score, getPlyFromRoot());
-            g_transpositionTable.store(hash, adjustedScore, depth, TT_EXACT,MOVE_NONE);
+            tt.store(hash, adjustedScore, depth, TT_EXACT,MOVE_NONE, staticEval);
         }
         recordExit(game, depth, score);
         return score;
@@ -234,6 +452,9 @@ int alphabeta(int alpha, int beta, int depth, Game& game){
     std::vector<std::pair<Move, int>> scoredMoves;
     scoredMoves.reserve(legalMoves.getNumMoves());
 
+    const int ply = getPlyFromRoot();
+    const Move counter = counterMove(game);
+
     for (int i = 0; i < legalMoves.getNumMoves(); ++i) {
         Move move = legalMoves.getMove(i);
         int moveScore = 0;
@@ -241,31 +462,23 @@ int alphabeta(int alpha, int beta, int depth, Game& game){
         if (ttBestMove == move){
             moveScore = 10000; // highest priority
             
-        } else if (getCapturedPiece(move) != nEmpty) {
-            // MVV-LVA scoring for captures
-            int victim = pieceScore( getCapturedPiece(move) );
-            int attacker = pieceScore( game.board.getPieceType(getFrom(move)) );
-
-            // MVV-LVA scoring for remaining captures  
-            int victimScore = victim / 100;
-            int attackerScore = attacker / 100;
-            moveScore = 1000 + (victimScore * 10) - attackerScore;
+        } else if (isCapture(move)) {
+            // MVV plus capture history: winning and even exchanges above the
+            // killers, losing ones after every quiet move
+            moveScore = (game.seeGE(move, 0) ? 1000 : -1000) + captureOrderScore(game, move);
 
         } else if (isKillerMove(move, depth)) {
             moveScore = 900;
 
+        } else if (move == counter) {
+            moveScore = 850;
+
         } else if (isPromotion(move) || isPromoCapture(move)) {
             moveScore = 800; // promotion bonus
 
-        } else if (isKingCastle(move) || isQueenCastle(move)) {
-            moveScore = 700; // castling bonus
-
         } else {
-            // center control
-            U8 to = getTo(move);
-            if (to == 28 || to == 29 || to == 35 || to == 36) { // e4, e5, d4, d5
-                moveScore = 100;
-            }
+            // remaining quiets by history, within +-512
+            moveScore = quietHistoryScore(game, move, ply) / 96;
         }
 
         scoredMoves.push_back({move, moveScore});
@@ -278,13 +491,67 @@ int alphabeta(int alpha, int beta, int depth, Game& game){
     int maxScore = -MATE_VALUE - 1; // worst possible score
     Move bestMove = scoredMoves[0].first; // Default to first legal move
 
+    // futility: quiet moves cannot lift a hopeless static eval to alpha
+    const int futilityValue = staticEval + g_futilityBase + g_futilityMargin * depth;
+    const bool futilityPruning = pruningNode && depth <= g_futilityMaxDepth && futilityValue <= alpha;
+
+    int movesSearched = 0;
+    Move quietsSearched[64];
+    int numQuietsSearched = 0;
+    Move capturesSearched[32];
+    int numCapturesSearched = 0;
     for (const auto& [move, moveScore] : scoredMoves) {
 
         if (isTimeUp()) break; 
 
+        const bool quiet = !isCapture(move) && !isPromotion(move);
+        const bool lmrCandidate = movesSearched > 0 && depth >= g_lmrMinDepth && movesSearched >= g_lmrMinMoves &&
+                                  !inCheck && quiet && !isKillerMove(move, depth);
+        const int historyScore = lmrCandidate ? quietHistoryScore(game, move, ply) : 0;
+
+        // PVS: the first move gets the full window, the rest a null-window
+        // scout that is re-searched only if it lands inside (alpha, beta)
+        g_searchStack[ply] = {move, game.board.getPieceIndex(getFrom(move))};
         game.pushMove(move);
-        int score = -alphabeta(-beta, -alpha, depth - 1, game);
+        const bool givesCheck = game.isInCheck();
+
+        if (futilityPruning && movesSearched > 0 && quiet && !givesCheck && !isKillerMove(move, depth)) {
+            game.popMove();
+            g_futilityPrunes++;
+            maxScore = std::max(maxScore, futilityValue);
+            continue;
+        }
+
+        int score;
+        if (movesSearched == 0) {
+            score = -alphabeta(-beta, -alpha, depth - 1, game, nodeType);
+        } else {
+            // LMR: late quiet moves get a shallower scout first, less so
+            // with a good history
+            int reduction = 0;
+            if (lmrCandidate && !givesCheck) {
+                reduction = lmrReduction(depth, movesSearched + 1) - (nodeType == PV_NODE ? 1 : 0) -
+                            historyScore / g_lmrHistoryDivisor;
+                reduction = std::clamp(reduction, 0, std::max(0, depth - 2));
+            }
+
+            if (reduction > 0) {
+                g_lmrReductions++;
+                score = -alphabeta(-alpha - 1, -alpha, depth - 1 - reduction, game, NON_PV_NODE);
+                if (score > alpha) {
+                    g_lmrResearches++;
+                    score = -alphabeta(-alpha - 1, -alpha, depth - 1, game, NON_PV_NODE);
+                }
+            } else {
+                score = -alphabeta(-alpha - 1, -alpha, depth - 1, game, NON_PV_NODE);
+            }
+            if (score > alpha && score < beta) {
+                g_pvsResearches++;
+                score = -alphabeta(-beta, -alpha, depth - 1, game, PV_NODE);
+            }
+        }
         game.popMove();
+        movesSearched++;
 
         if (score > maxScore) {
             maxScore = score;
@@ -294,11 +561,18 @@ int alphabeta(int alpha, int beta, int depth, Game& game){
         alpha = std::max(alpha, score);
 
         if (alpha >= beta) {
-            if (getCapturedPiece(move) == nEmpty) {
+            g_betaCutoffs++;
+            if (movesSearched == 1) g_firstMoveCutoffs++;
+            if (quiet) {
                 updateKillerMove(move, depth); // Update killer move
+                updateQuietHistory(game, move, quietsSearched, numQuietsSearched, depth, ply);
             }
+            updateCaptureHistory(game, isCapture(move) ? move : MOVE_NONE,
+                                 capturesSearched, numCapturesSearched, historyBonus(depth));
             break; // Prune remaining moves
         }
+        if (quiet && numQuietsSearched < 64) quietsSearched[numQuietsSearched++] = move;
+        if (isCapture(move) && numCapturesSearched < 32) capturesSearched[numCapturesSearched++] = move;
     }
 
     if (depth >= 0) {
@@ -311,7 +585,7 @@ int alphabeta(int alpha, int beta, int depth, Game& game){
             flag = TT_EXACT; // Exact score
         }
         int adjustedScore = adjustMateScore(maxScore, getPlyFromRoot());
-        g_transpositionTable.store(hash, adjustedScore, depth, flag, bestMove);
+        tt.store(hash, adjustedScore, depth, flag, bestMove, staticEval);
     }
 
     recordExit(game, depth, maxScore);
@@ -319,10 +593,8 @@ int alphabeta(int alpha, int beta, int depth, Game& game){
 }
 
 
-Move searchAtDepth(Game& game, int depth, const std::vector<Move>* rootFilter) {
-
+std::vector<RootMove> generateRootMoves(Game& game, const std::vector<Move>* rootFilter) {
     MovesStruct legalMoves = game.generateAllLegalMoves();
-    if (legalMoves.getNumMoves() == 0) return MOVE_NONE;
 
     std::unordered_set<U32> filterSet;
     if (rootFilter && !rootFilter->empty()) {
@@ -331,33 +603,209 @@ Move searchAtDepth(Game& game, int depth, const std::vector<Move>* rootFilter) {
             filterSet.insert(move);
         }
     }
-    
-    int alpha = -MATE_VALUE;
-    int bestScore = -MATE_VALUE;
-    int beta = MATE_VALUE;
-
-    Move bestMove;
-    bool foundMove = false;
 
+    std::vector<RootMove> rootMoves;
+    rootMoves.reserve(legalMoves.getNumMoves());
     for (int i = 0; i < legalMoves.getNumMoves(); ++i) {
-        if (isTimeUp()) break;
-        
         Move move = legalMoves.getMove(i);
         if (!filterSet.empty() && filterSet.find(move) == filterSet.end()) {
             continue;
         }
-        
-        game.pushMove(move);
-        int score = -alphabeta(-beta, -alpha, depth - 1, game);
+        rootMoves.push_back({move});
+    }
+
+    // a previous search of this position seeds the first iteration
+    Move ttBestMove = threadTranspositionTable().getBestMove(game.board.getHash());
+    auto hashMove = std::find_if(rootMoves.begin(), rootMoves.end(),
+                                 [&](const RootMove& rm) { return rm.move == ttBestMove; });
+    if (hashMove != rootMoves.end()) std::rotate(rootMoves.begin(), hashMove, hashMove + 1);
+    return rootMoves;
+}
+
+int searchRoot(Game& game, std::vector<RootMove>& rootMoves, int depth, int alpha, int beta) {
+    if (rootMoves.empty()) return ROOT_SCORE_NONE;
+
+    // with the root computed, every accumulator in the tree is incremental
+    game.refreshAccumulator();
+
+    const int originalAlpha = alpha;
+    int bestScore = ROOT_SCORE_NONE;
+    size_t bestIndex = 0;
+
+    for (size_t i = 0; i < rootMoves.size(); ++i) {
+        if (isTimeUp()) break;
+
+        RootMove& rootMove = rootMoves[i];
+        const long nodesBefore = g_nodeCount;
+
+        g_searchStack[0] = {rootMove.move, game.board.getPieceIndex(getFrom(rootMove.move))};
+        game.pushMove(rootMove.move);
+        int score;
+        if (i == 0) {
+            score = -alphabeta(-beta, -alpha, depth - 1, game, PV_NODE);
+        } else {
+            score = -alphabeta(-alpha - 1, -alpha, depth - 1, game, NON_PV_NODE);
+            if (score > alpha && score < beta) {
+                g_pvsResearches++;
+                score = -alphabeta(-beta, -alpha, depth - 1, game, PV_NODE);
+            }
+        }
         game.popMove();
 
-        if (score > bestScore || !foundMove) {
+        // a search cut short by the stop returns a meaningless score
+        if (isTimeUp()) break;
+
+        rootMove.score = score;
+        rootMove.nodes = g_nodeCount - nodesBefore;
+
+        if (score > bestScore) {
             bestScore = score;
-            bestMove = move;
-            foundMove = true;
+            bestIndex = i;
+        }
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) break;
+    }
+
+    if (bestScore == ROOT_SCORE_NONE) return ROOT_SCORE_NONE;
+
+    // after a fail low every score is only an upper bound, so the highest
+    // one says nothing about the best move: the order stays as it was
+    if (bestScore <= originalAlpha) {
+        if (!isTimeUp()) threadTranspositionTable().store(game.board.getHash(), bestScore, depth, TT_UPPER, rootMoves[0].move);
+        return bestScore;
+    }
+
+    // next iteration: this iteration's best first, the rest by effort spent
+    std::rotate(rootMoves.begin(), rootMoves.begin() + bestIndex, rootMoves.begin() + bestIndex + 1);
+    std::stable_sort(rootMoves.begin() + 1, rootMoves.end(),
+                     [](const RootMove& a, const RootMove& b) { return a.nodes > b.nodes; });
+
+    if (!isTimeUp()) {
+        TTFlag flag = bestScore <= originalAlpha ? TT_UPPER : (bestScore >= beta ? TT_LOWER : TT_EXACT);
+        threadTranspositionTable().store(game.board.getHash(), bestScore, depth, flag, rootMoves[0].move);
+    }
+    return bestScore;
+}
+
+int searchRootAspiration(Game& game, std::vector<RootMove>& rootMoves, int depth, int previousScore) {
+    if (depth < ASPIRATION_MIN_DEPTH || std::abs(previousScore) > MATE_THRESHOLD) {
+        return searchRoot(game, rootMoves, depth);
+    }
+
+    int delta = ASPIRATION_WINDOW;
+    int alpha = std::max(previousScore - delta, -MATE_VALUE);
+    int beta = std::min(previousScore + delta, MATE_VALUE);
+
+    while (true) {
+        int score = searchRoot(game, rootMoves, depth, alpha, beta);
+        if (score == ROOT_SCORE_NONE) return score;
+        // stopped before a score landed inside the window: a fail-low bound
+        // is no result, while a fail high still backs the move now in front
+        if (isTimeUp()) return score <= alpha ? ROOT_SCORE_NONE : score;
+
+        if (score <= alpha) {
+            g_aspirationFailLows++;
+            beta = (alpha + beta) / 2;
+            alpha = std::max(score - delta, -MATE_VALUE);
+        } else if (score >= beta) {
+            g_aspirationFailHighs++;
+            beta = std::min(score + delta, MATE_VALUE);
+        } else {
+            return score;
+        }
+
+        // a bound past the mate threshold says little about the distance
+        // to mate, so that side opens completely
+        delta += delta / 2;
+        if (delta > ASPIRATION_MAX_WINDOW) {
+            alpha = -MATE_VALUE;
+            beta = MATE_VALUE;
         }
+        if (score < -MATE_THRESHOLD) alpha = -MATE_VALUE;
+        if (score > MATE_THRESHOLD) beta = MATE_VALUE;
+    }
+}
+
+Move searchAtDepth(Game& game, int depth, const std::vector<Move>* rootFilter, int* bestScoreOut) {
+    std::vector<RootMove> rootMoves = generateRootMoves(game, rootFilter);
+    int score = searchRoot(game, rootMoves, depth);
+    if (score == ROOT_SCORE_NONE) return MOVE_NONE;
+    if (bestScoreOut) *bestScoreOut = score;
+    return rootMoves[0].move;
+}
+
+int& captureHistoryEntry(const Game& game, Move move) {
+    return g_captureHistory[game.board.getPieceIndex(getFrom(move))][getTo(move)][getCapturedPiece(move) - nPawns];
+}
+
+void updateCaptureHistory(const Game& game, Move cutoffMove, const Move* failedCaptures, int numFailed, int bonus) {
+    if (cutoffMove != MOVE_NONE) updateHistory(captureHistoryEntry(game, cutoffMove), bonus);
+    for (int i = 0; i < numFailed; ++i) {
+        updateHistory(captureHistoryEntry(game, failedCaptures[i]), -bonus);
+    }
+}
+
+int captureOrderScore(const Game& game, Move move) {
+    return pieceScore(getCapturedPiece(move)) / 10 - pieceScore(game.board.getPieceType(getFrom(move))) / 100 +
+           captureHistoryEntry(game, move) / 1024;
+}
+
+int historyBonus(int depth) {
+    return std::min(32 * depth * depth, 2048);
+}
+
+// gravity: the step shrinks as the entry nears +-HISTORY_MAX, so the table
+// never saturates and recent results outweigh old ones
+void updateHistory(int& entry, int bonus) {
+    entry += bonus - entry * std::abs(bonus) / HISTORY_MAX;
+}
+
+void updateHistory(int16_t& entry, int bonus) {
+    entry += bonus - entry * std::abs(bonus) / HISTORY_MAX;
+}
+
+int quietHistoryScore(const Game& game, Move move, int ply) {
+    const int pieceIndex = game.board.getPieceIndex(getFrom(move));
+    int score = g_history[game.board.friendlyColour()][getFrom(move)][getTo(move)];
+
+    ContinuationHistory& continuation = threadContinuationHistory();
+    for (int back = 1; back <= 2 && ply - back >= 0; ++back) {
+        const SearchStackEntry& previous = g_searchStack[ply - back];
+        if (previous.pieceIndex < 0) continue;
+        score += continuation.row(previous.pieceIndex, getTo(previous.move))[pieceIndex][getTo(move)];
+    }
+    return score;
+}
+
+Move counterMove(const Game& game) {
+    Move previous = game.lastMove();
+    if (previous == MOVE_NONE) return MOVE_NONE;
+    return g_counterMoves[game.board.getPieceIndex(getTo(previous))][getTo(previous)];
+}
+
+void updateQuietHistory(const Game& game, Move cutoffMove, const Move* failedQuiets, int numFailed, int depth, int ply) {
+    const int colour = game.board.friendlyColour();
+    const int bonus = historyBonus(depth);
+    ContinuationHistory& continuation = threadContinuationHistory();
+
+    auto update = [&](Move move, int amount) {
+        updateHistory(g_history[colour][getFrom(move)][getTo(move)], amount);
+        const int pieceIndex = game.board.getPieceIndex(getFrom(move));
+        for (int back = 1; back <= 2 && ply - back >= 0; ++back) {
+            const SearchStackEntry& previous = g_searchStack[ply - back];
+            if (previous.pieceIndex < 0) continue;
+            updateHistory(continuation.row(previous.pieceIndex, getTo(previous.move))[pieceIndex][getTo(move)], amount);
+        }
+    };
+    update(cutoffMove, bonus);
+    for (int i = 0; i < numFailed; ++i) {
+        update(failedQuiets[i], -bonus);
+    }
+
+    Move previous = game.lastMove();
+    if (previous != MOVE_NONE) {
+        g_counterMoves[game.board.getPieceIndex(getTo(previous))][getTo(previous)] = cutoffMove;
     }
-    return foundMove ? bestMove :MOVE_NONE;
 }
 
 void updateKillerMove(Move move, int depth) {
@@ -373,9 +821,11 @@ bool isKillerMove(Move move, int depth) {
 }
 
 int quiescenceSearch(int alpha, int beta, Game& game, int qDepth) {
+    TranspositionTable& tt = threadTranspositionTable();
 
     g_nodeCount++;
-    if (isTimeUp()) return evalForSide(game);
+    g_qsearchNodes++;
+    if (isTimeUp() || getPlyFromRoot() + qDepth >= MAX_SEARCH_PLY) return evalForSide(game);
 
     U64 hash = game.board.getHash();
     Move ttBestMove = MOVE_NONE;
@@ -386,15 +836,18 @@ int quiescenceSearch(int alpha, int beta, Game& game, int qDepth) {
     int ttScore;
 
     g_ttProbes++;
-    if (g_transpositionTable.probe(hash, alpha, beta, ttDepth, ttScore)) {
+    if (tt.probe(hash, alpha, beta, ttDepth, ttScore)) {
         g_ttHits++;
         return restoreMateScore(ttScore, getPlyFromRoot());
     }
 
-    ttBestMove = g_transpositionTable.getBestMove(hash);
+    ttBestMove = tt.getBestMove(hash);
 
     int originalAlpha = alpha;
-    int standPat = evalForSide(game);
+
+    // the TT keeps the static eval, so a revisit skips the evaluator
+    int standPat = tt.getStaticEval(hash);
+    if (standPat == STATIC_EVAL_NONE) standPat = evalForSide(game);
 
     const int DELTA_MARGIN = 900; // Queen value
     if (standPat + DELTA_MARGIN < alpha) {
@@ -402,7 +855,7 @@ int quiescenceSearch(int alpha, int beta, Game& game, int qDepth) {
     }
 
     if (standPat >= beta) {
-        g_transpositionTable.store(hash, standPat, ttDepth, TT_LOWER,MOVE_NONE);
+        tt.store(hash, standPat, ttDepth, TT_LOWER,MOVE_NONE, standPat);
         return standPat;
     }
 
@@ -411,7 +864,7 @@ int quiescenceSearch(int alpha, int beta, Game& game, int qDepth) {
     MovesStruct captureMoves = game.generateAllLegalMoves(true); // Generate only capture moves);
 
     if (captureMoves.getNumMoves() == 0) {
-        g_transpositionTable.store(hash, standPat, ttDepth, TT_EXACT,MOVE_NONE);
+        tt.store(hash, standPat, ttDepth, TT_EXACT,MOVE_NONE, standPat);
         return standPat;
     }
 
@@ -425,16 +878,13 @@ int quiescenceSearch(int alpha, int beta, Game& game, int qDepth) {
         if (ttBestMove == move) {
             moveScore = 10000; // highest priority
         } else {
-            // MVV-LVA scoring for captures
-            int victim = pieceScore( getCapturedPiece(move) ) / 100;
-            int attacker = pieceScore( game.board.getPieceType(getFrom(move)) ) / 100;
-            moveScore = 1000 + (victim * 10) - attacker; // simple MVV-LVA heuristic
+            moveScore = 1000 + captureOrderScore(game, move);
         }
         scoredCaptures.push_back({move, moveScore});
     }   
 
     if (scoredCaptures.empty()) {
-        g_transpositionTable.store(hash, standPat, 0, TT_EXACT,MOVE_NONE);
+        tt.store(hash, standPat, 0, TT_EXACT,MOVE_NONE, standPat);
         return standPat;
     }
 
@@ -444,30 +894,36 @@ int quiescenceSearch(int alpha, int beta, Game& game, int qDepth) {
     Move bestMove;
     bool foundMove = false;
     int bestScore = standPat;
+    Move capturesSearched[32];
+    int numCapturesSearched = 0;
 
     for (const auto& scoredCapture : scoredCaptures) {
         Move move = scoredCapture.first;
 
         if (isTimeUp()) break;
 
-        // SEE(Static Exchange Evaluation) pruning
-        // int victim = pieceScore(getCapturedPiece(move)) / 100;
-        // int attacker = pieceScore(game.board.getPieceType(getFrom(move))) / 100;
-        // int see = (victim * 100) - (attacker * 100); // Simple SEE approximation
+        // captures that keep failing are skipped, except the hash move
+        if (move != ttBestMove && captureHistoryEntry(game, move) < -g_qsHistoryPrune) {
+            g_qsearchHistoryPrunes++;
+            continue;
+        }
 
-        // // Skip obviously bad captures (losing more than we gain)
-        // if (see < -100) {
-        //     continue;
-        // }
+        // captures that lose material once the exchange plays out
+        if (!game.seeGE(move, 0)) {
+            g_qsearchSeePrunes++;
+            continue;
+        }
 
         game.pushMove(move);
         int score = -quiescenceSearch(-beta, -alpha, game, qDepth + 1);
         game.popMove();
 
         if (score >= beta) {
-            g_transpositionTable.store(hash, score, ttDepth, TT_LOWER,MOVE_NONE);
+            updateCaptureHistory(game, move, capturesSearched, numCapturesSearched, historyBonus(1));
+            tt.store(hash, score, ttDepth, TT_LOWER,MOVE_NONE, standPat);
             return score; // beta cutoff
         }
+        if (numCapturesSearched < 32) capturesSearched[numCapturesSearched++] = move;
 
         if (score > bestScore) {
             bestScore = score;
@@ -493,7 +949,7 @@ int quiescenceSearch(int alpha, int beta, Game& game, int qDepth) {
 
     int adjustedScore = adjustMateScore(bestScore, getPlyFromRoot());
     Move storeMove = foundMove ? bestMove :MOVE_NONE;
-    g_transpositionTable.store(hash, adjustedScore, ttDepth, flag, storeMove);
+    tt.store(hash, adjustedScore, ttDepth, flag, storeMove, standPat);
 
     return bestScore;
 }
\ No newline at end of file
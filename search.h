@@ -3,33 +3,129 @@
 
 #include "evaluation.h"
 #include "transposition.h"
+#include "evalcache.h"
+#include <cstring>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include <atomic>
+#include <chrono>
 
 const int MATE_VALUE = 30000;
 const int MATE_THRESHOLD = 29000;  
 const int STALEMATE_VALUE = 0;
+static_assert(nnue::MAX_EVAL < MATE_THRESHOLD, "network evals must not look like mate scores");
 
-extern long g_nodeCount;
-extern long g_ttHits;
-extern long g_ttProbes;
+// search state is per thread so independent searches (self-play workers) can
+// run side by side; only the stop flag is shared
+extern thread_local long g_nodeCount;
+extern thread_local long g_ttHits;
+extern thread_local long g_ttProbes;
+extern thread_local long g_pvNodes;
+extern thread_local long g_pvsResearches;
+extern thread_local long g_aspirationFailLows;
+extern thread_local long g_aspirationFailHighs;
+extern thread_local long g_nullMoveTries;
+extern thread_local long g_nullMoveCutoffs;
+extern thread_local long g_lmrReductions;
+extern thread_local long g_lmrResearches;
+extern thread_local long g_reverseFutilityCutoffs;
+extern thread_local long g_razorTries;
+extern thread_local long g_razorCutoffs;
+extern thread_local long g_futilityPrunes;
+// fail-high nodes in alphabeta, and how many of them failed high on the first move
+extern thread_local long g_betaCutoffs;
+extern thread_local long g_firstMoveCutoffs;
+extern thread_local long g_qsearchNodes; // included in g_nodeCount
+extern thread_local long g_qsearchHistoryPrunes;
+extern thread_local long g_qsearchSeePrunes;
 
-extern std::chrono::steady_clock::time_point g_searchStartTime;
-extern long g_timeLimit;
-extern long g_nodeLimit;
+extern thread_local std::chrono::steady_clock::time_point g_searchStartTime;
+extern thread_local long g_timeLimit;
+extern thread_local long g_nodeLimit;
 
 const int MAX_SEARCH_DEPTH = 50;
-extern Move killerMoves[MAX_SEARCH_DEPTH][2];
+extern thread_local Move killerMoves[MAX_SEARCH_DEPTH][2];
+
+// quiet-move ordering, per thread like the killers and cleared with the stats:
+// butterfly history [colour][from][to] with gravity updates bounded by
+// HISTORY_MAX, and the quiet reply that refuted a move, indexed by the moved
+// piece (0-11) and its destination
+const int HISTORY_MAX = 16384;
+extern thread_local int g_history[2][64][64];
+extern thread_local Move g_counterMoves[12][64];
+
+// capture history [moving piece][to][captured type], same gravity as the
+// quiet tables; adjusts MVV ordering and prunes captures in quiescence
+extern thread_local int g_captureHistory[12][64][6];
+extern int g_qsHistoryPrune; // qsearch skips captures with history below -this
+
+int& captureHistoryEntry(const Game& game, Move move);
+// after a fail-high: bonus for a capturing cutoff move (MOVE_NONE if it was
+// quiet), malus for the captures searched before it
+void updateCaptureHistory(const Game& game, Move cutoffMove, const Move* failedCaptures, int numFailed, int bonus);
+// MVV-LVA (victim value / 10 - attacker value / 100) plus capture history / 1024,
+// which can move a capture by up to 16 either way
+int captureOrderScore(const Game& game, Move move);
+
+int historyBonus(int depth);
+void updateHistory(int& entry, int bonus);
+void updateHistory(int16_t& entry, int bonus);
+// butterfly plus continuation history (one and two plies back) of a quiet
+// move at a node `ply` moves from the root
+int quietHistoryScore(const Game& game, Move move, int ply);
+// the refuting quiet for the opponent's last move, MOVE_NONE after a null move
+Move counterMove(const Game& game);
+// after a quiet fail-high: bonus for the cutoff move, malus for the quiets
+// searched before it (butterfly and continuation tables), and the counter move
+void updateQuietHistory(const Game& game, Move cutoffMove, const Move* failedQuiets, int numFailed, int depth, int ply);
+
+// Game's fast-mode history holds 64 states; deeper lines return the static eval
+const int MAX_SEARCH_PLY = 60;
+
+// moves made along the current line, indexed by ply from the root (the root
+// move is ply 0); pieceIndex is the moved piece (0-11), -1 for a null move
+struct SearchStackEntry {
+    Move move = MOVE_NONE;
+    int pieceIndex = -1;
+};
+extern thread_local SearchStackEntry g_searchStack[MAX_SEARCH_PLY];
+
+// continuation history [previous piece][previous to][piece][to], shared by the
+// ply-1 and ply-2 lookups. int16 entries (within +-HISTORY_MAX), and all the
+// entries one node reads for its moves share a 1.5 KB row picked by the
+// earlier move
+class ContinuationHistory {
+public:
+    using Row = int16_t[12][64];
+
+    ContinuationHistory() : rows(new Row[12 * 64]) { clear(); }
+
+    void clear() { std::memset(rows.get(), 0, sizeof(Row) * 12 * 64); }
+    Row& row(int pieceIndex, int to) { return rows[pieceIndex * 64 + to]; }
+
+private:
+    std::unique_ptr<Row[]> rows;
+};
+
+ContinuationHistory& threadContinuationHistory();
 
 // record search tree for debugging
-extern std::vector<std::string> g_searchTree;
-extern int g_currentPly;
-extern bool g_recordSearchTree;
+extern thread_local std::vector<std::string> g_searchTree;
+extern thread_local int g_currentPly;
+extern thread_local bool g_recordSearchTree;
 extern size_t g_searchTreeMaxLines;
 
 using namespace evaluation;
 
+// PV nodes are searched with an open window and may return an exact score;
+// non-PV nodes only ever see a null window (beta == alpha + 1) and are the
+// ones later pruning may treat more aggressively
+enum NodeType {
+    PV_NODE,
+    NON_PV_NODE
+};
+
 void startSearchTree();
 void stopAndPrintSearchTree(size_t maxLines = 100000);
 void recordEntry(const Game& game, int depth, int alpha, int beta);
@@ -41,9 +137,93 @@ void resetStopSearchFlag();
 bool isStopSearchRequested();
 void setNodeLimit(long limit);
 
-Move searchAtDepth(Game& game, int depth, const std::vector<Move>* rootFilter = nullptr);
+// root moves persist across iterative-deepening iterations: each keeps the
+// score and subtree size of its last search, and the list is re-sorted after
+// every iteration (best move first, then by subtree size)
+struct RootMove {
+    Move move = MOVE_NONE;
+    int score = -MATE_VALUE;
+    long nodes = 0;
+};
+
+// returned by searchRoot when no root move finished before the stop
+const int ROOT_SCORE_NONE = -MATE_VALUE - 1;
+
+// legal root moves (restricted to rootFilter if given), hash move first
+std::vector<RootMove> generateRootMoves(Game& game, const std::vector<Move>* rootFilter = nullptr);
+// one iteration over the list in its current order; alpha is raised as better
+// moves are found. Returns the best score, or ROOT_SCORE_NONE if interrupted
+// before the first move completed (the list then keeps its previous order).
+// A fail low (score <= alpha) also leaves the order unchanged
+int searchRoot(Game& game, std::vector<RootMove>& rootMoves, int depth,
+               int alpha = -MATE_VALUE, int beta = MATE_VALUE);
+
+// aspiration windows: from ASPIRATION_MIN_DEPTH on, searchRoot starts with a
+// window of +-ASPIRATION_WINDOW around the previous iteration's score and
+// widens the failing side (by half again each time) until the score lands
+// inside. Mate scores and windows past ASPIRATION_MAX_WINDOW fall back to a
+// full window. A stop during a fail low returns ROOT_SCORE_NONE
+const int ASPIRATION_MIN_DEPTH = 4;
+const int ASPIRATION_WINDOW = 40;
+const int ASPIRATION_MAX_WINDOW = 600;
+int searchRootAspiration(Game& game, std::vector<RootMove>& rootMoves, int depth, int previousScore);
+
+// null-move pruning: at non-PV nodes of at least NULL_MOVE_MIN_DEPTH whose
+// static eval is already >= beta, pass and search the reply with reduction
+// base + depth / divisor + (eval - beta) / 200 (the last term capped at 3)
+const int NULL_MOVE_MIN_DEPTH = 3;
+const int NULL_MOVE_BASE_REDUCTION = 2;
+const int NULL_MOVE_DEPTH_DIVISOR = 6;
+
+// late move reductions: quiet, non-killer, non-checking moves from the
+// LmrMinMoves-th on at depth >= LmrMinDepth are searched with reduction
+// LmrBase/100 + ln(depth) * ln(moveNumber) / (LmrDivisor/100) (one less at PV
+// nodes, and adjusted by quietHistoryScore / LmrHistoryDivisor) and
+// re-searched at full depth if they beat alpha
+const int LMR_TABLE_MOVES = 64;
+extern int g_lmrBase;
+extern int g_lmrDivisor;
+extern int g_lmrMinDepth;
+extern int g_lmrMinMoves;
+extern int g_lmrHistoryDivisor; // quiet history per ply of reduction removed or added
+void initReductions();
+int lmrReduction(int depth, int moveNumber);
+
+// near-leaf pruning at non-PV nodes not in check, from the static eval:
+// - reverse futility: depth <= RfpMaxDepth and eval - RfpMargin * depth >= beta
+//   returns the eval
+// - razoring: depth <= RazorMaxDepth and eval + RazorBase + RazorMargin * depth
+//   < alpha drops into qsearch, which is trusted if it also fails low
+// - futility: depth <= FutilityMaxDepth and eval + FutilityBase +
+//   FutilityMargin * depth <= alpha skips quiet, non-killer, non-checking
+//   moves after the first
+// a max depth of 0 turns the technique off
+extern int g_rfpMaxDepth;
+extern int g_rfpMargin;
+extern int g_razorMaxDepth;
+extern int g_razorBase;
+extern int g_razorMargin;
+extern int g_futilityMaxDepth;
+extern int g_futilityBase;
+extern int g_futilityMargin;
+
+// search parameters exposed as UCI spin options for tuning
+struct SearchTunable {
+    const char* name;
+    int* value;
+    int defaultValue;
+    int min;
+    int max;
+};
+const std::vector<SearchTunable>& searchTunables();
+// false if no tunable has that name; the value is clamped to its range
+bool setSearchTunable(const std::string& name, int value);
+
+// one-shot root search; bestScore (optional) receives the root score from the
+// side to move's view
+Move searchAtDepth(Game& game, int depth, const std::vector<Move>* rootFilter = nullptr, int* bestScore = nullptr);
 int quiescenceSearch(int alpha, int beta, Game& game, int qDepth);
-int alphabeta(int alpha, int beta, int depth, Game& game);
+int alphabeta(int alpha, int beta, int depth, Game& game, NodeType nodeType);
 int getTerminalValue(Game& game);
 void resetSearchStats();
 void printSearchStats();
@@ -53,9 +233,25 @@ int restoreMateScore(int score, int ply);
 void updateKillerMove(Move move, int depth);
 bool isKillerMove(Move move, int depth);
 
+// keeps network and handcrafted evals apart in the eval cache
+const U64 NNUE_EVAL_KEY = 0x9E3779B97F4A7C15ULL;
+
 static inline int evalForSide(const Game& game) {
-    int whiteScore = evaluateBoard(game.board); // always white-perspective
-    return (game.board.gameInfo & 1) ? whiteScore : -whiteScore;
+    EvalCache& cache = threadEvalCache();
+    const bool useNetwork = nnue::isActive();
+    const U64 key = useNetwork ? (game.board.hash ^ NNUE_EVAL_KEY) : game.board.hash;
+
+    int score;
+    if (cache.probe(key, score)) return score;
+
+    if (useNetwork) {
+        score = nnue::evaluate(game.board, game.currentAccumulator()); // already side-to-move
+    } else {
+        int whiteScore = evaluateBoard(game.board); // always white-perspective
+        score = (game.board.gameInfo & 1) ? whiteScore : -whiteScore;
+    }
+    cache.store(key, score);
+    return score;
 }
 
 
@@ -0,0 +1,141 @@
+#include "selfplay.h"
+#include "game.h"
+#include "search.h"
+#include "transposition.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace selfplay {
+
+namespace {
+
+const size_t WRITE_BUFFER_SAMPLES = 4096;
+
+// iterative deepening until the depth or node budget runs out, keeping the
+// root move list between iterations; an interrupted iteration is only used
+// when nothing deeper finished
+Move searchMove(Game& game, const Settings& settings, int& score) {
+    game.enableFastMode();
+    g_searchStartTime = std::chrono::steady_clock::now();
+    g_timeLimit = std::numeric_limits<long>::max();
+    setNodeLimit(settings.nodes > 0 ? settings.nodes : -1);
+    resetSearchStats();
+
+    const int targetDepth = settings.depth > 0 ? std::min(settings.depth, MAX_SEARCH_DEPTH - 1) : MAX_SEARCH_DEPTH - 1;
+    std::vector<RootMove> rootMoves = generateRootMoves(game);
+    Move bestMove = MOVE_NONE;
+    for (int depth = 1; depth <= targetDepth && !rootMoves.empty(); ++depth) {
+        int depthScore = searchRootAspiration(game, rootMoves, depth, score);
+        bool interrupted = isTimeUp();
+        if (depthScore != ROOT_SCORE_NONE && (!interrupted || bestMove == MOVE_NONE)) {
+            bestMove = rootMoves[0].move;
+            score = depthScore;
+        }
+        if (interrupted) break;
+    }
+
+    setNodeLimit(-1);
+    game.disableFastMode();
+    return bestMove;
+}
+
+// random legal moves from the start position; false if the game ended on the way
+bool playRandomOpening(Game& game, int plies, std::mt19937_64& rng) {
+    for (int ply = 0; ply < plies; ++ply) {
+        MovesStruct moves = game.generateAllLegalMoves();
+        if (moves.getNumMoves() == 0) return false;
+        game.pushMove(moves.getMove(rng() % moves.getNumMoves()));
+    }
+    return game.generateAllLegalMoves().getNumMoves() > 0;
+}
+
+} // namespace
+
+GameResult playGame(const Settings& settings, std::mt19937_64& rng, std::vector<PackedPosition>& samples) {
+    Game game;
+    do {
+        game.reset();
+    } while (!playRandomOpening(game, settings.randomPlies, rng));
+    threadTranspositionTable().clear();
+
+    const size_t firstSample = samples.size();
+    std::vector<int> scores;
+    GameResult result = DRAW;
+
+    for (int ply = 0; ply < settings.maxPlies; ++ply) {
+        if (game.generateAllLegalMoves().getNumMoves() == 0) {
+            bool whiteToMove = game.board.gameInfo & TURN_MASK;
+            result = !game.isInCheck() ? DRAW : (whiteToMove ? BLACK_WIN : WHITE_WIN);
+            break;
+        }
+        if (game.isDrawByRule()) break;
+
+        int score = 0;
+        Move move = searchMove(game, settings, score);
+        if (move == MOVE_NONE) break;
+
+        // label only quiet positions: tuners and trainers evaluate them statically
+        bool quiet = !game.isInCheck() && !isCapture(move) && !isPromotion(move) && !isPromoCapture(move);
+        if (quiet && std::abs(score) < MATE_THRESHOLD) {
+            samples.push_back(game.board.encode());
+            scores.push_back((game.board.gameInfo & TURN_MASK) ? score : -score);
+        }
+        game.pushMove(move);
+    }
+
+    for (size_t i = 0; i < scores.size(); ++i) setSample(samples[firstSample + i], scores[i], result);
+    return result;
+}
+
+Stats generate(const Settings& settings, std::FILE* out) {
+    const int threads = std::max(1, settings.threads);
+    std::mutex outputMutex;
+    std::vector<Stats> threadStats(threads);
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&](int index) {
+        TranspositionTable table(settings.hashMb);
+        setThreadTranspositionTable(&table);
+        std::mt19937_64 rng(settings.seed * 0x9E3779B97F4A7C15ULL + index);
+
+        std::vector<PackedPosition> buffer;
+        buffer.reserve(WRITE_BUFFER_SAMPLES + 1024);
+        auto flush = [&]() {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::fwrite(buffer.data(), sizeof(PackedPosition), buffer.size(), out);
+            buffer.clear();
+        };
+
+        // games are dealt round robin so the totals add up for any thread count
+        for (long game = index; game < settings.games; game += threads) {
+            size_t before = buffer.size();
+            playGame(settings, rng, buffer);
+            threadStats[index].games++;
+            threadStats[index].positions += static_cast<long>(buffer.size() - before);
+            if (buffer.size() >= WRITE_BUFFER_SAMPLES) flush();
+        }
+        flush();
+        setThreadTranspositionTable(nullptr);
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int t = 0; t < threads; ++t) workers.emplace_back(worker, t);
+    for (auto& thread : workers) thread.join();
+
+    Stats total;
+    for (const Stats& stats : threadStats) {
+        total.games += stats.games;
+        total.positions += stats.positions;
+    }
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total;
+}
+
+} // namespace selfplay
@@ -0,0 +1,65 @@
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include "board.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Self-play training data: fixed-node or fixed-depth games, one Game, search
+// state and transposition table per worker thread. Each sample is a 32-byte
+// PackedPosition whose reserved bytes carry the search score and game result.
+
+namespace selfplay {
+
+enum GameResult : U8 {
+    BLACK_WIN = 0,
+    DRAW = 1,
+    WHITE_WIN = 2
+};
+
+struct Settings {
+    int threads = 1;
+    long games = 100;       // in total, split across threads
+    long nodes = 5000;      // per move, <= 0 for no limit
+    int depth = 0;          // per move, <= 0 for no limit (one of nodes/depth must be set)
+    int randomPlies = 8;    // random legal moves before the engine takes over
+    int maxPlies = 400;     // longer games are scored as draws
+    size_t hashMb = 16;     // per thread
+    U64 seed = 1;
+};
+
+struct Stats {
+    long games = 0;
+    long positions = 0;
+    double seconds = 0.0;
+};
+
+// score from white's side in centipawns, result of the game the position came from
+inline void setSample(PackedPosition& record, int whiteScore, GameResult result) {
+    I16 score = static_cast<I16>(whiteScore);
+    record.reserved[0] = static_cast<U8>(score & 0xFF);
+    record.reserved[1] = static_cast<U8>((score >> 8) & 0xFF);
+    record.reserved[2] = result;
+    record.reserved[3] = 0;
+}
+
+inline int sampleScore(const PackedPosition& record) {
+    return static_cast<I16>(record.reserved[0] | (record.reserved[1] << 8));
+}
+
+inline GameResult sampleResult(const PackedPosition& record) {
+    return static_cast<GameResult>(record.reserved[2]);
+}
+
+// plays one game on the calling thread and appends its quiet, non-mate
+// positions to samples; uses the thread's search state and transposition table
+GameResult playGame(const Settings& settings, std::mt19937_64& rng, std::vector<PackedPosition>& samples);
+
+// plays settings.games games on settings.threads threads, writing samples to out
+Stats generate(const Settings& settings, std::FILE* out);
+
+} // namespace selfplay
+
+#endif // SELFPLAY_H
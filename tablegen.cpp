@@ -0,0 +1,372 @@
+// Build-time generator for every precomputed lookup table (king/knight/pawn
+// moves, rays, Zobrist keys and the magic/PEXT slider tables).
+//
+// usage: ./tablegen tables_generated.cpp
+//
+// The Makefile runs this once and compiles the output, so the engine starts
+// with all tables already in .rodata instead of rebuilding them per process.
+
+#include "attackgen.h"
+#include "types.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace attackgen;
+
+namespace {
+
+constexpr U64 RMagics[64] = {
+    0x2080020500400f0ULL, 0x28444000400010ULL, 0x20000a1004100014ULL,
+    0x20010c090202006ULL, 0x8408008200810004ULL, 0x1746000808002ULL,
+    0x2200098000808201ULL, 0x12c0002080200041ULL, 0x104000208e480804ULL,
+    0x8084014008281008ULL, 0x4200810910500410ULL, 0x100014481c20400cULL,
+    0x4014a4040020808ULL, 0x401002001010a4ULL, 0x202000500010001ULL,
+    0x8112808005810081ULL, 0x40902108802020ULL, 0x42002101008101ULL,
+    0x459442200810c202ULL, 0x81001103309808ULL, 0x8110000080102ULL,
+    0x8812806008080404ULL, 0x104020000800101ULL, 0x40a1048000028201ULL,
+    0x4100ba0000004081ULL, 0x44803a4003400109ULL, 0xa010a00000030443ULL,
+    0x91021a000100409ULL, 0x4201e8040880a012ULL, 0x22a000440201802ULL,
+    0x30890a72000204ULL, 0x10411402a0c482ULL, 0x40004841102088ULL,
+    0x40230000100040ULL, 0x40100010000a0488ULL, 0x1410100200050844ULL,
+    0x100090808508411ULL, 0x1410040024001142ULL, 0x8840018001214002ULL,
+    0x410201000098001ULL, 0x8400802120088848ULL, 0x2060080000021004ULL,
+    0x82101002000d0022ULL, 0x1001101001008241ULL, 0x9040411808040102ULL,
+    0x600800480009042ULL, 0x1a020000040205ULL, 0x4200404040505199ULL,
+    0x2020081040080080ULL, 0x40a3002000544108ULL, 0x4501100800148402ULL,
+    0x81440280100224ULL, 0x88008000000804ULL, 0x8084060000002812ULL,
+    0x1840201000108312ULL, 0x5080202000000141ULL, 0x1042a180880281ULL,
+    0x900802900c01040ULL, 0x8205104104120ULL, 0x9004220000440aULL,
+    0x8029510200708ULL, 0x8008440100404241ULL, 0x2420001111000bdULL,
+    0x4000882304000041ULL,
+};
+
+constexpr U64 BMagics[64] = {
+    0x100420000431024ULL,  0x280800101073404ULL,  0x42000a00840802ULL,
+    0xca800c0410c2ULL,     0x81004290941c20ULL,   0x400200450020250ULL,
+    0x444a019204022084ULL, 0x88610802202109aULL,  0x11210a0800086008ULL,
+    0x400a08c08802801ULL,  0x1301a0500111c808ULL, 0x1280100480180404ULL,
+    0x720009020028445ULL,  0x91880a9000010a01ULL, 0x31200940150802b2ULL,
+    0x5119080c20000602ULL, 0x242400a002448023ULL, 0x4819006001200008ULL,
+    0x222c10400020090ULL,  0x302008420409004ULL,  0x504200070009045ULL,
+    0x210071240c02046ULL,  0x1182219000022611ULL, 0x400c50000005801ULL,
+    0x4004010000113100ULL, 0x2008121604819400ULL, 0xc4a4010000290101ULL,
+    0x404a000888004802ULL, 0x8820c004105010ULL,   0x28280100908300ULL,
+    0x4c013189c0320a80ULL, 0x42008080042080ULL,   0x90803000c080840ULL,
+    0x2180001028220ULL,    0x1084002a040036ULL,   0x212009200401ULL,
+    0x128110040c84a84ULL,  0x81488020022802ULL,   0x8c0014100181ULL,
+    0x2222013020082ULL,    0xa00100002382c03ULL,  0x1000280001005c02ULL,
+    0x84801010000114cULL,  0x480410048000084ULL,  0x21204420080020aULL,
+    0x2020010000424a10ULL, 0x240041021d500141ULL, 0x420844000280214ULL,
+    0x29084a280042108ULL,  0x84102a8080a20a49ULL, 0x104204908010212ULL,
+    0x40a20280081860c1ULL, 0x3044000200121004ULL, 0x1001008807081122ULL,
+    0x50066c000210811ULL,  0xe3001240f8a106ULL,   0x940c0204030020d4ULL,
+    0x619204000210826aULL, 0x2010438002b00a2ULL,  0x884042004005802ULL,
+    0xa90240000006404ULL,  0x500d082244010008ULL, 0x28190d00040014e0ULL,
+    0x825201600c082444ULL,
+};
+
+constexpr int RBits[64] = {
+    12, 11, 11, 11, 11, 11, 11, 12,
+    11, 10, 10, 10, 10, 10, 10, 11,
+    11, 10, 10, 10, 10, 10, 10, 11,
+    11, 10, 10, 10, 10, 10, 10, 11,
+    11, 10, 10, 10, 10, 10, 10, 11,
+    11, 10, 10, 10, 10, 10, 10, 11,
+    11, 10, 10, 10, 10, 10, 10, 11,
+    12, 11, 11, 11, 11, 11, 11, 12,
+};
+
+static_assert(RBits[0] == 12, "Unexpected RBits[0]");
+static_assert(RBits[56] == 12, "Unexpected RBits[56]");
+
+constexpr int BBits[64] = {
+    6, 5, 5, 5, 5, 5, 5, 6,
+    5, 5, 5, 5, 5, 5, 5, 5,
+    5, 5, 7, 7, 7, 7, 5, 5,
+    5, 5, 7, 9, 9, 7, 5, 5,
+    5, 5, 7, 9, 9, 7, 5, 5,
+    5, 5, 7, 7, 7, 7, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5,
+    6, 5, 5, 5, 5, 5, 5, 6,
+};
+
+static_assert(BBits[0] == 6, "Unexpected BBits[0]");
+static_assert(BBits[63] == 6, "Unexpected BBits[63]");
+
+
+constexpr size_t ROOK_TABLE_SIZE = 102400;
+constexpr size_t BISHOP_TABLE_SIZE = 5248;
+
+struct Tables {
+    U64 kingBB[64];
+    U64 knightBB[64];
+    U64 pawnMovesBB[2][64];
+    U64 pawnMovesCapturesBB[2][64];
+    U64 rays[64][64];
+
+    U64 zobristTable[12][64];
+    U64 zobristSideToMove;
+    U64 zobristCastling[16];
+    U64 zobristEnPassant[8];
+
+    U64 rookMasks[64];
+    U64 bishopMasks[64];
+    U32 rookOffsets[64];
+    U32 bishopOffsets[64];
+    std::vector<U64> rookAttackTable;
+    std::vector<U64> bishopAttackTable;
+    std::vector<U64> rookPextTable;
+    std::vector<U64> bishopPextTable;
+};
+
+U64 randomU64(U64& seed) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return seed;
+}
+
+void updateBitboard(U64 &bitboard, int row, int col, const int move[2]) {
+    int newRow = row + move[0], newCol = col + move[1];
+    if (newRow >= 0 && newRow < 8 && newCol >= 0 && newCol < 8) {
+        bitboard |= 1ULL << (newRow * 8 + newCol);
+    }
+}
+
+void generateKingMoves(Tables& t) {
+    const int setKingMoves[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1},  {-1, -1}, {-1, 1} };
+
+    for (int square = 0; square < 64; square++) {
+        U64 kingMoves_i = 0ULL;
+        int col = square % 8, row = square / 8;
+        for (int i = 0; i < 8; i++) {
+            updateBitboard(kingMoves_i, row, col, setKingMoves[i]);
+        }
+        t.kingBB[square] = kingMoves_i;
+    }
+}
+
+void generateKnightMoves(Tables& t) {
+    const int setKnightMoves[8][2] = { {2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2} };
+
+    for (int square = 0; square < 64; square++) {
+        U64 knightMoves_i = 0ULL;
+        int col = square % 8, row = square / 8;
+        for (int i = 0; i < 8; i++) {
+            updateBitboard(knightMoves_i, row, col, setKnightMoves[i]);
+        }
+        t.knightBB[square] = knightMoves_i;
+    }
+}
+
+void generatePawnMoves(Tables& t) {
+    for (int square = 0; square < 64; square++) {
+        int col = square % 8, row = square / 8;
+        U64 whiteMoves = 0ULL, blackMoves = 0ULL;
+        U64 whiteCaptures = 0ULL, blackCaptures = 0ULL;
+
+        // White pawns move up (to higher rows)
+        if (row + 1 < 8) whiteMoves |= 1ULL << ((row + 1) * 8 + col);
+        if (row == 1)    whiteMoves |= 1ULL << ((row + 2) * 8 + col);
+        // Black pawns move down (to lower rows)
+        if (row - 1 >= 0) blackMoves |= 1ULL << ((row - 1) * 8 + col);
+        if (row == 6)     blackMoves |= 1ULL << ((row - 2) * 8 + col);
+
+        // White captures up
+        if (col + 1 < 8 && row + 1 < 8) whiteCaptures |= 1ULL << ((row + 1) * 8 + col + 1);
+        if (col - 1 >= 0 && row + 1 < 8) whiteCaptures |= 1ULL << ((row + 1) * 8 + col - 1);
+        // Black captures down
+        if (col - 1 >= 0 && row - 1 >= 0) blackCaptures |= 1ULL << ((row - 1) * 8 + col - 1);
+        if (col + 1 < 8 && row - 1 >= 0) blackCaptures |= 1ULL << ((row - 1) * 8 + col + 1);
+
+        t.pawnMovesBB[nWhite][square] = whiteMoves;
+        t.pawnMovesBB[nBlack][square] = blackMoves;
+        t.pawnMovesCapturesBB[nWhite][square] = whiteCaptures;
+        t.pawnMovesCapturesBB[nBlack][square] = blackCaptures;
+    }
+}
+
+void generateRays(Tables& t) {
+    for (int from = 0; from < 64; from++) {
+        for (int to = 0; to < 64; to++) {
+            int fromRow = from / 8, fromCol = from % 8;
+            int toRow = to / 8, toCol = to % 8;
+
+            int rowDiff = toRow - fromRow;
+            int colDiff = toCol - fromCol;
+
+            bool sameRank = fromRow == toRow;
+            bool sameFile = fromCol == toCol;
+            bool sameDiagonal = abs(fromRow - toRow) == abs(fromCol - toCol);
+
+            if (!sameRank && !sameFile && !sameDiagonal) {
+                t.rays[from][to] = 0ULL;
+                continue;
+            }
+
+            int rowDir = (rowDiff == 0) ? 0 : (rowDiff > 0) ? 1 : -1;
+            int colDir = (colDiff == 0) ? 0 : (colDiff > 0) ? 1 : -1;
+
+            U64 ray = 0ULL;
+            int r = fromRow + rowDir;
+            int c = fromCol + colDir;
+
+            while (r >= 0 && r < 8 && c >= 0 && c < 8) {
+                int square = r * 8 + c;
+                ray |= 1ULL << square;
+                if (square == to) break;
+                r += rowDir;
+                c += colDir;
+            }
+            t.rays[from][to] = ray;
+        }
+    }
+}
+
+void generateZobristTables(Tables& t) {
+    U64 seed = 1070372; // fixed seed for reproducibility
+
+    for (int piece = 0; piece < 12; piece++) {
+        for (int square = 0; square < 64; square++) {
+            t.zobristTable[piece][square] = randomU64(seed);
+        }
+    }
+    t.zobristSideToMove = randomU64(seed);
+    for (int i = 0; i < 16; i++) {
+        t.zobristCastling[i] = randomU64(seed);
+    }
+    for (int i = 0; i < 8; i++) {
+        t.zobristEnPassant[i] = randomU64(seed);
+    }
+}
+
+// fills the magic-indexed and pext-indexed tables for one slider type,
+// returns false on a destructive magic collision
+bool generateSliderTables(const U64 magics[64], const int bits[64], U64 masks[64], U32 offsets[64],
+                          std::vector<U64>& magicTable, std::vector<U64>& pextTable,
+                          U64 (*maskFn)(int), U64 (*attacksFn)(int, U64), const char* name) {
+    size_t offset = 0;
+    for (int square = 0; square < 64; ++square) {
+        masks[square] = maskFn(square);
+        if (__builtin_popcountll(masks[square]) != bits[square]) {
+            fprintf(stderr, "%s bits mismatch on square %d\n", name, square);
+            return false;
+        }
+        offsets[square] = static_cast<U32>(offset);
+        offset += 1ULL << bits[square];
+    }
+
+    magicTable.assign(offset, 0ULL);
+    pextTable.assign(offset, 0ULL);
+
+    for (int square = 0; square < 64; ++square) {
+        size_t entries = 1ULL << bits[square];
+        std::vector<uint8_t> filled(entries, 0);
+        for (size_t index = 0; index < entries; ++index) {
+            U64 blockers = setOccupancy(static_cast<int>(index), bits[square], masks[square]);
+            U64 attacks = attacksFn(square, blockers);
+            size_t magicIndex = magicTransform(blockers, magics[square], bits[square]);
+
+            U64& slot = magicTable[offsets[square] + magicIndex];
+            if (filled[magicIndex] && slot != attacks) {
+                fprintf(stderr, "%s magic collision at square %d\n", name, square);
+                return false;
+            }
+            slot = attacks;
+            filled[magicIndex] = 1;
+
+            pextTable[offsets[square] + index] = attacks;
+        }
+    }
+    return true;
+}
+
+void emitArray(FILE* out, const char* decl, const U64* values, size_t count) {
+    fprintf(out, "%s = {", decl);
+    for (size_t i = 0; i < count; ++i) {
+        fprintf(out, "%s0x%llxULL,", (i % 4 == 0) ? "\n    " : " ", (unsigned long long)values[i]);
+    }
+    fprintf(out, "\n};\n\n");
+}
+
+void emitArray(FILE* out, const char* decl, const U32* values, size_t count) {
+    fprintf(out, "%s = {", decl);
+    for (size_t i = 0; i < count; ++i) {
+        fprintf(out, "%s%u,", (i % 8 == 0) ? "\n    " : " ", values[i]);
+    }
+    fprintf(out, "\n};\n\n");
+}
+
+void emitArray(FILE* out, const char* decl, const int* values, size_t count) {
+    fprintf(out, "%s = {", decl);
+    for (size_t i = 0; i < count; ++i) {
+        fprintf(out, "%s%d,", (i % 8 == 0) ? "\n    " : " ", values[i]);
+    }
+    fprintf(out, "\n};\n\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <output.cpp>\n", argv[0]);
+        return 1;
+    }
+
+    static Tables t;
+    generateKingMoves(t);
+    generateKnightMoves(t);
+    generatePawnMoves(t);
+    generateRays(t);
+    generateZobristTables(t);
+
+    if (!generateSliderTables(RMagics, RBits, t.rookMasks, t.rookOffsets, t.rookAttackTable, t.rookPextTable,
+                              generateRookMask, rookAttacksOnTheFly, "Rook") ||
+        !generateSliderTables(BMagics, BBits, t.bishopMasks, t.bishopOffsets, t.bishopAttackTable, t.bishopPextTable,
+                              generateBishopMask, bishopAttacksOnTheFly, "Bishop")) {
+        return 1;
+    }
+
+    if (t.rookAttackTable.size() != ROOK_TABLE_SIZE || t.bishopAttackTable.size() != BISHOP_TABLE_SIZE) {
+        fprintf(stderr, "slider table sizes do not match bitboard.h\n");
+        return 1;
+    }
+
+    FILE* out = fopen(argv[1], "w");
+    if (!out) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "// Generated by tablegen.cpp - do not edit.\n\n");
+    fprintf(out, "#include \"bitboard.h\"\n#include \"movetables.h\"\n\n");
+
+    emitArray(out, "const U64 MoveTables::kingBB[64]", t.kingBB, 64);
+    emitArray(out, "const U64 MoveTables::knightBB[64]", t.knightBB, 64);
+    emitArray(out, "const U64 MoveTables::pawnMovesBB[2][64]", &t.pawnMovesBB[0][0], 2 * 64);
+    emitArray(out, "const U64 MoveTables::pawnMovesCapturesBB[2][64]", &t.pawnMovesCapturesBB[0][0], 2 * 64);
+    emitArray(out, "const U64 MoveTables::rays[64][64]", &t.rays[0][0], 64 * 64);
+    emitArray(out, "const U64 MoveTables::zobristTable[12][64]", &t.zobristTable[0][0], 12 * 64);
+    fprintf(out, "const U64 MoveTables::zobristSideToMove = 0x%llxULL;\n\n", (unsigned long long)t.zobristSideToMove);
+    emitArray(out, "const U64 MoveTables::zobristCastling[16]", t.zobristCastling, 16);
+    emitArray(out, "const U64 MoveTables::zobristEnPassant[8]", t.zobristEnPassant, 8);
+
+    emitArray(out, "const U64 MagicBitboard::rookMasks[64]", t.rookMasks, 64);
+    emitArray(out, "const U64 MagicBitboard::bishopMasks[64]", t.bishopMasks, 64);
+    emitArray(out, "const U64 MagicBitboard::rookMagics[64]", RMagics, 64);
+    emitArray(out, "const U64 MagicBitboard::bishopMagics[64]", BMagics, 64);
+    emitArray(out, "const int MagicBitboard::rookRelevantBits[64]", RBits, 64);
+    emitArray(out, "const int MagicBitboard::bishopRelevantBits[64]", BBits, 64);
+    emitArray(out, "const U32 MagicBitboard::rookOffsets[64]", t.rookOffsets, 64);
+    emitArray(out, "const U32 MagicBitboard::bishopOffsets[64]", t.bishopOffsets, 64);
+    emitArray(out, "const U64 MagicBitboard::rookAttackTable[ROOK_TABLE_SIZE]", t.rookAttackTable.data(), ROOK_TABLE_SIZE);
+    emitArray(out, "const U64 MagicBitboard::bishopAttackTable[BISHOP_TABLE_SIZE]", t.bishopAttackTable.data(), BISHOP_TABLE_SIZE);
+    emitArray(out, "const U64 MagicBitboard::rookPextTable[ROOK_TABLE_SIZE]", t.rookPextTable.data(), ROOK_TABLE_SIZE);
+    emitArray(out, "const U64 MagicBitboard::bishopPextTable[BISHOP_TABLE_SIZE]", t.bishopPextTable.data(), BISHOP_TABLE_SIZE);
+
+    if (fclose(out) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    return 0;
+}
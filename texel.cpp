@@ -0,0 +1,375 @@
+#include "texel.h"
+#include "batch.h"
+#include "game.h"
+#include "pawns.h"
+#include "selfplay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace texel {
+
+namespace {
+
+const int MAX_LEAF_PLY = 16;
+const double LN10 = 2.302585092994046;
+
+inline double sigmoid(double score, double k) {
+    return 1.0 / (1.0 + std::exp(-k * score * LN10 / 400.0));
+}
+
+bool isMgOnly(int term) {
+    return term == SHIELD_NEAR || term == SHIELD_FAR;
+}
+
+int sideToMoveEval(const Board& board) {
+    int score = evaluation::evaluateBoardFull(board);
+    return (board.gameInfo & TURN_MASK) ? score : -score;
+}
+
+// fail-hard capture search that also reports the position its score came from
+int quietLeaf(Game& game, int alpha, int beta, int ply, Board& leaf) {
+    int standPat = sideToMoveEval(game.board);
+    leaf = game.board;
+    if (standPat >= beta || ply >= MAX_LEAF_PLY) return standPat;
+    if (standPat > alpha) alpha = standPat;
+
+    MovesStruct captures = game.generateAllLegalMoves(true);
+    std::vector<std::pair<int, Move>> ordered;
+    ordered.reserve(captures.getNumMoves());
+    for (int i = 0; i < captures.getNumMoves(); ++i) {
+        Move move = captures.getMove(i);
+        int victim = evaluation::pieceScore(static_cast<enumPiece>(getCapturedPiece(move)));
+        int attacker = evaluation::pieceScore(game.board.getPieceType(getFrom(move)));
+        ordered.push_back({victim * 10 - attacker, move});
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    Board childLeaf;
+    for (const auto& [order, move] : ordered) {
+        game.pushMove(move);
+        int score = -quietLeaf(game, -beta, -alpha, ply + 1, childLeaf);
+        game.popMove();
+        if (score > alpha) {
+            alpha = score;
+            leaf = childLeaf;
+            if (alpha >= beta) break;
+        }
+    }
+    return alpha;
+}
+
+void addFeature(std::vector<Feature>& features, int term, int count) {
+    if (count != 0) features.push_back({term, count});
+}
+
+} // namespace
+
+Params fromEvalParams(const evaluation::EvalParams& source) {
+    Params params{};
+    for (int piece = 0; piece < 5; ++piece) {
+        params.mg[MATERIAL + piece] = source.pieceValueMg[piece];
+        params.eg[MATERIAL + piece] = source.pieceValueEg[piece];
+    }
+    for (int piece = 0; piece < 6; ++piece) {
+        for (int square = 0; square < 64; ++square) {
+            params.mg[PST + piece * 64 + square] = source.pstMg[piece][square];
+            params.eg[PST + piece * 64 + square] = source.pstEg[piece][square];
+        }
+    }
+    params.mg[DOUBLED] = source.doubledMg;
+    params.eg[DOUBLED] = source.doubledEg;
+    params.mg[ISOLATED] = source.isolatedMg;
+    params.eg[ISOLATED] = source.isolatedEg;
+    params.mg[BACKWARD] = source.backwardMg;
+    params.eg[BACKWARD] = source.backwardEg;
+    for (int rank = 0; rank < 8; ++rank) {
+        params.mg[PASSED + rank] = source.passedMg[rank];
+        params.eg[PASSED + rank] = source.passedEg[rank];
+    }
+    params.mg[SHIELD_NEAR] = source.shieldNear;
+    params.mg[SHIELD_FAR] = source.shieldFar;
+    return params;
+}
+
+evaluation::EvalParams toEvalParams(const Params& params) {
+    auto round = [](double value) { return static_cast<int>(std::lround(value)); };
+    evaluation::EvalParams result{};
+    for (int piece = 0; piece < 5; ++piece) {
+        result.pieceValueMg[piece] = round(params.mg[MATERIAL + piece]);
+        result.pieceValueEg[piece] = round(params.eg[MATERIAL + piece]);
+    }
+    for (int piece = 0; piece < 6; ++piece) {
+        for (int square = 0; square < 64; ++square) {
+            result.pstMg[piece][square] = round(params.mg[PST + piece * 64 + square]);
+            result.pstEg[piece][square] = round(params.eg[PST + piece * 64 + square]);
+        }
+    }
+    result.doubledMg = round(params.mg[DOUBLED]);
+    result.doubledEg = round(params.eg[DOUBLED]);
+    result.isolatedMg = round(params.mg[ISOLATED]);
+    result.isolatedEg = round(params.eg[ISOLATED]);
+    result.backwardMg = round(params.mg[BACKWARD]);
+    result.backwardEg = round(params.eg[BACKWARD]);
+    for (int rank = 0; rank < 8; ++rank) {
+        result.passedMg[rank] = round(params.mg[PASSED + rank]);
+        result.passedEg[rank] = round(params.eg[PASSED + rank]);
+    }
+    result.shieldNear = round(params.mg[SHIELD_NEAR]);
+    result.shieldFar = round(params.mg[SHIELD_FAR]);
+    return result;
+}
+
+int extractFeatures(const Board& board, std::vector<Feature>& features) {
+    features.clear();
+
+    int material[5] = {};
+    U64 pieces = board.getAllPieces();
+    while (pieces) {
+        int square = __builtin_ctzll(pieces);
+        pieces &= pieces - 1;
+        int piece = board.getPieceType(square) - nPawns;
+        bool white = board.getColourType(square) == nWhite;
+        int sign = white ? 1 : -1;
+        if (piece < 5) material[piece] += sign;
+        features.push_back({PST + piece * 64 + evaluation::pstSquare(square, white), sign});
+    }
+    for (int piece = 0; piece < 5; ++piece) addFeature(features, MATERIAL + piece, material[piece]);
+
+    pawns::PawnTrace trace;
+    pawns::PawnEntry entry;
+    pawns::evaluatePawns(board, entry, &trace);
+    pawns::kingShield(board, &trace);
+    addFeature(features, DOUBLED, trace.doubled[nWhite] - trace.doubled[nBlack]);
+    addFeature(features, ISOLATED, trace.isolated[nWhite] - trace.isolated[nBlack]);
+    addFeature(features, BACKWARD, trace.backward[nWhite] - trace.backward[nBlack]);
+    for (int rank = 0; rank < 8; ++rank) {
+        addFeature(features, PASSED + rank, trace.passed[nWhite][rank] - trace.passed[nBlack][rank]);
+    }
+    addFeature(features, SHIELD_NEAR, trace.shieldNear[nWhite] - trace.shieldNear[nBlack]);
+    addFeature(features, SHIELD_FAR, trace.shieldFar[nWhite] - trace.shieldFar[nBlack]);
+
+    return std::min(evaluation::computePhase(board), evaluation::MAX_PHASE);
+}
+
+double evaluate(const Params& params, const std::vector<Feature>& features, int phase) {
+    double mg = 0.0, eg = 0.0;
+    for (const Feature& feature : features) {
+        mg += feature.count * params.mg[feature.term];
+        eg += feature.count * params.eg[feature.term];
+    }
+    return (mg * phase + eg * (evaluation::MAX_PHASE - phase)) / evaluation::MAX_PHASE;
+}
+
+Board resolveLeaf(const Board& board) {
+    Game game;
+    game.setPosition(board);
+    if (game.isInCheck()) return board;
+
+    game.enableFastMode();
+    Board leaf;
+    quietLeaf(game, -evaluation::Qwt * 100, evaluation::Qwt * 100, 0, leaf);
+    game.disableFastMode();
+    return leaf;
+}
+
+Dataset::~Dataset() {
+    if (records) munmap(const_cast<PackedPosition*>(records), mappedBytes);
+}
+
+bool Dataset::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0 || info.st_size % sizeof(PackedPosition) != 0) {
+        close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+    madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+
+    if (records) munmap(const_cast<PackedPosition*>(records), mappedBytes);
+    records = static_cast<const PackedPosition*>(mapped);
+    mappedBytes = info.st_size;
+    count = mappedBytes / sizeof(PackedPosition);
+    return true;
+}
+
+std::vector<Sample> prepareSamples(const Dataset& data, size_t limit, int threads) {
+    size_t count = limit > 0 ? std::min(limit, data.size()) : data.size();
+    std::vector<Sample> samples(count);
+    std::vector<char> valid(count, 0);
+
+    batch::parallelFor(count, threads, [&](size_t begin, size_t end) {
+        Board board;
+        for (size_t i = begin; i < end; ++i) {
+            if (!board.decode(data[i])) continue;
+            samples[i].leaf = resolveLeaf(board).encode();
+            samples[i].result = static_cast<float>(selfplay::sampleResult(data[i]) * 0.5);
+            samples[i].score = selfplay::sampleScore(data[i]);
+            samples[i].target = samples[i].result;
+            valid[i] = 1;
+        }
+    });
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (valid[i]) samples[kept++] = samples[i];
+    }
+    samples.resize(kept);
+    return samples;
+}
+
+void blendTargets(std::vector<Sample>& samples, double lambda, double k) {
+    for (Sample& sample : samples) {
+        sample.target = static_cast<float>(lambda * sigmoid(sample.score, k) + (1.0 - lambda) * sample.result);
+    }
+}
+
+double computeLoss(const Params& params, const std::vector<Sample>& samples, double k, int threads,
+                   Params* gradient) {
+    threads = std::max(1, threads);
+    std::vector<double> losses(threads, 0.0);
+    std::vector<Params> gradients(gradient ? threads : 0, Params{});
+    size_t chunk = (samples.size() + threads - 1) / threads;
+
+    // one contiguous range and one set of accumulators per thread
+    batch::parallelFor(threads, threads, [&](size_t firstThread, size_t lastThread) {
+        std::vector<Feature> features;
+        Board board;
+        for (size_t t = firstThread; t < lastThread; ++t) {
+            size_t begin = std::min(samples.size(), t * chunk);
+            size_t end = std::min(samples.size(), begin + chunk);
+            double loss = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+                board.decode(samples[i].leaf);
+                int phase = extractFeatures(board, features);
+                double predicted = sigmoid(evaluate(params, features, phase), k);
+                double error = samples[i].target - predicted;
+                loss += error * error;
+                if (!gradient) continue;
+
+                // d(error^2)/d(eval), the phase split is applied per term below
+                double slope = -2.0 * error * predicted * (1.0 - predicted) * k * LN10 / 400.0;
+                double mgWeight = slope * phase / evaluation::MAX_PHASE;
+                double egWeight = slope - mgWeight;
+                Params& g = gradients[t];
+                for (const Feature& feature : features) {
+                    g.mg[feature.term] += mgWeight * feature.count;
+                    if (!isMgOnly(feature.term)) g.eg[feature.term] += egWeight * feature.count;
+                }
+            }
+            losses[t] = loss;
+        }
+    });
+
+    double total = 0.0;
+    for (double loss : losses) total += loss;
+    if (gradient) {
+        *gradient = Params{};
+        for (const Params& g : gradients) {
+            for (int term = 0; term < NUM_TERMS; ++term) {
+                gradient->mg[term] += g.mg[term] / samples.size();
+                gradient->eg[term] += g.eg[term] / samples.size();
+            }
+        }
+    }
+    return samples.empty() ? 0.0 : total / samples.size();
+}
+
+double fitScalingConstant(const Params& params, const std::vector<Sample>& samples, int threads) {
+    // the loss is unimodal in k: golden-section search
+    const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+    double low = 0.1, high = 4.0;
+    double a = high - ratio * (high - low), b = low + ratio * (high - low);
+    double lossA = computeLoss(params, samples, a, threads);
+    double lossB = computeLoss(params, samples, b, threads);
+    for (int i = 0; i < 20; ++i) {
+        if (lossA < lossB) {
+            high = b;
+            b = a;
+            lossB = lossA;
+            a = high - ratio * (high - low);
+            lossA = computeLoss(params, samples, a, threads);
+        } else {
+            low = a;
+            a = b;
+            lossA = lossB;
+            b = low + ratio * (high - low);
+            lossB = computeLoss(params, samples, b, threads);
+        }
+    }
+    return (low + high) / 2.0;
+}
+
+namespace {
+
+void writeList(std::ofstream& out, const int* values, int count) {
+    out << "{";
+    for (int i = 0; i < count; ++i) out << (i ? ", " : "") << values[i];
+    out << "}";
+}
+
+void writeTable(std::ofstream& out, const char* name, const int (&values)[6][64]) {
+    static const char* PIECE_NAMES[6] = {"pawn", "knight", "bishop", "rook", "queen", "king"};
+    out << "    { // " << name << "\n";
+    for (int piece = 0; piece < 6; ++piece) {
+        out << "        { // " << PIECE_NAMES[piece] << "\n";
+        for (int row = 0; row < 8; ++row) {
+            out << "        ";
+            for (int col = 0; col < 8; ++col) {
+                out << std::setw(4) << values[piece][row * 8 + col];
+                if (row < 7 || col < 7) out << ",";
+            }
+            out << "\n";
+        }
+        out << "        },\n";
+    }
+    out << "    },\n";
+}
+
+} // namespace
+
+bool writeHeader(const std::string& path, const Params& params, const std::string& comment) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    const evaluation::EvalParams tuned = toEvalParams(params);
+
+    out << "#ifndef TUNED_PARAMS_H\n#define TUNED_PARAMS_H\n\n";
+    out << "// generated by tuner, do not edit: " << comment << "\n";
+    out << "// evaluation.h includes this after EvalParams when built with\n";
+    out << "// TUNED_EVAL_PARAMS=1 and uses it as DEFAULT_PARAMS\n\n";
+    out << "namespace evaluation {\n\n";
+    out << "inline constexpr EvalParams TUNED_PARAMS = {\n";
+
+    out << "    ";
+    writeList(out, tuned.pieceValueMg, 6);
+    out << ", // pieceValueMg\n    ";
+    writeList(out, tuned.pieceValueEg, 6);
+    out << ", // pieceValueEg\n";
+    writeTable(out, "pstMg", tuned.pstMg);
+    writeTable(out, "pstEg", tuned.pstEg);
+    out << "    " << tuned.doubledMg << ", " << tuned.doubledEg << ", // doubledMg, doubledEg\n";
+    out << "    " << tuned.isolatedMg << ", " << tuned.isolatedEg << ", // isolatedMg, isolatedEg\n";
+    out << "    " << tuned.backwardMg << ", " << tuned.backwardEg << ", // backwardMg, backwardEg\n    ";
+    writeList(out, tuned.passedMg, 8);
+    out << ", // passedMg\n    ";
+    writeList(out, tuned.passedEg, 8);
+    out << ", // passedEg\n";
+    out << "    " << tuned.shieldNear << ", " << tuned.shieldFar << ", // shieldNear, shieldFar\n";
+
+    out << "};\n\n} // namespace evaluation\n\n#endif // TUNED_PARAMS_H\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace texel
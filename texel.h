@@ -0,0 +1,102 @@
+#ifndef TEXEL_H
+#define TEXEL_H
+
+#include "board.h"
+#include "evaluation.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Texel tuning of the handcrafted evaluation: material, piece-square tables
+// and the pawn terms. The evaluation is linear in these parameters for a
+// fixed phase, so a position is reduced to a list of (term, count) pairs and
+// the sigmoid error is minimised by full-batch gradient descent.
+
+namespace texel {
+
+// term layout, each term has a middlegame and an endgame weight
+const int MATERIAL = 0;                 // pawn..queen
+const int PST = MATERIAL + 5;           // piece * 64 + table square (diagram order, see evaluation.h)
+const int DOUBLED = PST + 6 * 64;
+const int ISOLATED = DOUBLED + 1;
+const int BACKWARD = ISOLATED + 1;
+const int PASSED = BACKWARD + 1;        // + relative rank
+const int SHIELD_NEAR = PASSED + 8;     // middlegame only
+const int SHIELD_FAR = SHIELD_NEAR + 1; // middlegame only
+const int NUM_TERMS = SHIELD_FAR + 1;
+
+struct Params {
+    double mg[NUM_TERMS];
+    double eg[NUM_TERMS];
+};
+
+// white-minus-black count of each term that fires in a position
+struct Feature {
+    int term;
+    int count;
+};
+
+// conversion from/to the engine's weights (rounded to centipawns)
+Params fromEvalParams(const evaluation::EvalParams& params);
+evaluation::EvalParams toEvalParams(const Params& params);
+
+// features of the position plus its phase (0..MAX_PHASE, clamped)
+int extractFeatures(const Board& board, std::vector<Feature>& features);
+
+// white-perspective evaluation from the features; with the engine's current
+// weights this matches evaluation::evaluateBoard up to integer rounding
+double evaluate(const Params& params, const std::vector<Feature>& features, int phase);
+
+// the quiet position at the end of the capture sequence a quiescence search
+// would play from here (the position itself when it is quiet or in check)
+Board resolveLeaf(const Board& board);
+
+// a labelled position ready for tuning
+struct Sample {
+    PackedPosition leaf;
+    float target;   // expected score for white, 0..1
+    float result;   // game result for white, 0..1
+    int score;      // recorded search score, white's side, centipawns
+};
+
+// memory-mapped stream of self-play records (selfplay.h)
+class Dataset {
+public:
+    Dataset() = default;
+    ~Dataset();
+    Dataset(const Dataset&) = delete;
+    Dataset& operator=(const Dataset&) = delete;
+
+    bool open(const std::string& path);
+    size_t size() const { return count; }
+    const PackedPosition& operator[](size_t i) const { return records[i]; }
+
+private:
+    const PackedPosition* records = nullptr;
+    size_t count = 0;
+    size_t mappedBytes = 0;
+};
+
+// resolves leaves in parallel; the targets start out as the game results
+std::vector<Sample> prepareSamples(const Dataset& data, size_t limit, int threads);
+
+// target = lambda * sigmoid(score, k) + (1 - lambda) * result, with the same
+// k the loss will use (fit it on the result-only targets first)
+void blendTargets(std::vector<Sample>& samples, double lambda, double k);
+
+// mean squared error of sigmoid(k * eval / 400) against the targets, and its
+// gradient when gradient is not null
+double computeLoss(const Params& params, const std::vector<Sample>& samples, double k, int threads,
+                   Params* gradient = nullptr);
+
+// scaling constant k that best fits the current evaluation to the targets
+double fitScalingConstant(const Params& params, const std::vector<Sample>& samples, int threads);
+
+// writes the parameters, rounded, as a C++ header defining a constexpr
+// evaluation::EvalParams TUNED_PARAMS (see TUNED_EVAL_PARAMS in evaluation.h)
+bool writeHeader(const std::string& path, const Params& params, const std::string& comment);
+
+} // namespace texel
+
+#endif // TEXEL_H
@@ -1,20 +1,34 @@
 #include "transposition.h"
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <new>
 
 // gloabl instance
 TranspositionTable g_transpositionTable;
 
+namespace {
+thread_local TranspositionTable* t_threadTable = nullptr;
+}
+
+TranspositionTable& threadTranspositionTable() {
+    return t_threadTable ? *t_threadTable : g_transpositionTable;
+}
+
+void setThreadTranspositionTable(TranspositionTable* table) {
+    t_threadTable = table;
+}
+
 TranspositionTable::TranspositionTable(size_t sizeInMB) : entries(nullptr), size(0) {
     resize(sizeInMB);
 }
 
 TranspositionTable::~TranspositionTable() {
-    delete[] entries;
+    std::free(entries);
 }
 
 void TranspositionTable::resize(size_t sizeInMB) {
-    delete[] entries;
+    std::free(entries);
 
     size_t bytesAvailable = sizeInMB * 1024 * 1024;
     size_t entriesRequested = bytesAvailable / sizeof(TTEntry);
@@ -25,8 +39,10 @@ void TranspositionTable::resize(size_t sizeInMB) {
     }
     sizeMask = size - 1;
 
-    entries = new TTEntry[size];
-    clear();
+    // calloc hands back lazily zeroed pages, so a fresh table costs nothing at
+    // startup until the search actually touches it
+    entries = static_cast<TTEntry*>(std::calloc(size, sizeof(TTEntry)));
+    if (!entries) throw std::bad_alloc();
 
      std::cerr << "TT initialized: " << (size * sizeof(TTEntry)) / (1024 * 1024) << "MB (" << size << " entries)" << std::endl;
 }
@@ -41,7 +57,7 @@ bool TranspositionTable::probe(U64 key, int alpha, int beta, int depth, int& sco
     size_t index = key & sizeMask;
     TTEntry& entry = entries[index];
 
-    if (entry.key != key) {
+    if (entry.key != keyCheck(key)) {
         return false; // not found
     }
 
@@ -74,11 +90,12 @@ bool TranspositionTable::probe(U64 key, int alpha, int beta, int depth, int& sco
     return false;
 }
 
-void TranspositionTable::store(U64 key, int score, int depth, TTFlag flag, Move bestMove) {
+void TranspositionTable::store(U64 key, int score, int depth, TTFlag flag, Move bestMove, int staticEval) {
     if (depth < 0) depth = 0; // Prevent negative depths
 
     size_t index = key & sizeMask;
     TTEntry& entry = entries[index];
+    const U32 check = keyCheck(key);
 
     // replace if :
     // 1. key is empty (0)
@@ -86,7 +103,8 @@ void TranspositionTable::store(U64 key, int score, int depth, TTFlag flag, Move
     // 3. new search is deeper
     
     if (entry.key == 0) {
-        entry.key = key;
+        entry.key = check;
+        entry.staticEval = staticEval;
         entry.score = score;
         entry.depth = depth;
         entry.flag = flag;
@@ -94,9 +112,9 @@ void TranspositionTable::store(U64 key, int score, int depth, TTFlag flag, Move
         return;
     }
 
-    if (entry.key == key) {
+    if (entry.key == check) {
+        if (staticEval != STATIC_EVAL_NONE) entry.staticEval = staticEval;
         if (depth >= entry.depth || flag == TT_EXACT) {
-            entry.key = key;
             entry.score = score;
             entry.depth = depth;
             entry.flag = flag;
@@ -106,7 +124,8 @@ void TranspositionTable::store(U64 key, int score, int depth, TTFlag flag, Move
     }
 
     if (depth >= entry.depth) {
-        entry.key = key;
+        entry.key = check;
+        entry.staticEval = staticEval;
         entry.score = score;
         entry.depth = depth;
         entry.flag = flag;
@@ -118,12 +137,17 @@ Move TranspositionTable::getBestMove(U64 key) {
     size_t index = key & sizeMask;
     TTEntry& entry = entries[index];
     
-    if (entry.key == key) {
+    if (entry.key == keyCheck(key)) {
         return entry.bestMove;
     }
     return MOVE_NONE;
 }
 
+int TranspositionTable::getStaticEval(U64 key) {
+    const TTEntry& entry = entries[key & sizeMask];
+    return (entry.key == keyCheck(key)) ? entry.staticEval : STATIC_EVAL_NONE;
+}
+
 double TranspositionTable::getUsage() const {
     if (!entries || size == 0) return 0.0;
 
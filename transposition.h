@@ -14,13 +14,18 @@ enum TTFlag {
     TT_UPPER = 2
 };
 
+// no static eval stored in the entry
+const int STATIC_EVAL_NONE = -32768;
+
 struct TTEntry {
-    U64 key;        // Zobrist hash key (8 bytes)
+    U32 key;        // Upper 32 bits of the Zobrist key, the lower bits pick the slot (4 bytes)
     Move bestMove;  // Best move (4 bytes)
     I16 score;      // Score (2 bytes) - signed
+    I16 staticEval; // Side-to-move static eval or STATIC_EVAL_NONE (2 bytes)
     U8 depth;       // Search depth (1 byte)
     U8 flag;        // TTFlag (1 byte)
 };
+static_assert(sizeof(TTEntry) == 16, "TTEntry should stay 16 bytes");
 
 class TranspositionTable {
 private:
@@ -29,6 +34,9 @@ private:
     size_t size;
     size_t sizeMask;
 
+    // never 0, so zeroed (empty) slots cannot match a position
+    static U32 keyCheck(U64 key) { return static_cast<U32>(key >> 32) | 1; }
+
     
 public:
     TranspositionTable(size_t sizeInMB = DEFAULT_SIZE_MB);
@@ -38,13 +46,15 @@ public:
     void resize(size_t sizeInMB);
     
     bool probe(U64 key, int alpha, int beta, int depth, int& score);
-    void store(U64 key, int score, int depth, TTFlag flag, Move bestMove);
+    // staticEval = STATIC_EVAL_NONE keeps whatever eval the entry already had for this key
+    void store(U64 key, int score, int depth, TTFlag flag, Move bestMove, int staticEval = STATIC_EVAL_NONE);
     
     // Statistics
     size_t getSize() const { return size; }
     double getUsage() const;
 
     Move getBestMove(U64 key);
+    int getStaticEval(U64 key); // STATIC_EVAL_NONE if unknown
 
     
     // Disable copy constructor and assignment
@@ -56,6 +66,11 @@ public:
 // ✅ Global TT instance
 extern TranspositionTable g_transpositionTable;
 
+// the table searches on this thread use: g_transpositionTable unless the thread
+// installed its own (self-play workers keep a private table each)
+TranspositionTable& threadTranspositionTable();
+void setThreadTranspositionTable(TranspositionTable* table); // nullptr restores the global
+
 
 
 
@@ -0,0 +1,142 @@
+#include "batch.h"
+#include "movetables.h"
+#include "texel.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+// Texel tuner: fits material, piece-square tables and pawn terms to a
+// self-play dataset (datagen output) and writes them as a header, e.g.
+// `tuner data.bin --threads 8 --epochs 200 --out tuned_params.h`. Tuning
+// starts from --init (an evaluation parameter file) or the built-in weights;
+// --params also saves the result in that format for the engine's EvalParams option.
+
+void printUsage() {
+    cerr << "usage: tuner <data.bin> [--threads N] [--epochs N] [--lr X] [--lambda X]" << endl;
+    cerr << "             [--limit N] [--out tuned_params.h] [--init in.txt] [--params out.txt]" << endl;
+}
+
+double secondsSince(steady_clock::time_point start) {
+    return duration_cast<microseconds>(steady_clock::now() - start).count() / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    string dataPath = argv[1];
+    string outputPath = "tuned_params.h";
+    string initPath, paramsPath;
+    int threads = batch::defaultThreads();
+    int epochs = 100;
+    double learningRate = 1.0;
+    double lambda = 0.0;
+    size_t limit = 0;
+
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--threads") {
+            threads = max(1, atoi(value));
+        } else if (arg == "--epochs") {
+            epochs = max(0, atoi(value));
+        } else if (arg == "--lr") {
+            learningRate = atof(value);
+        } else if (arg == "--lambda") {
+            lambda = atof(value);
+        } else if (arg == "--limit") {
+            limit = strtoull(value, nullptr, 10);
+        } else if (arg == "--out") {
+            outputPath = value;
+        } else if (arg == "--init") {
+            initPath = value;
+        } else if (arg == "--params") {
+            paramsPath = value;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    MoveTables::instance().init();
+
+    evaluation::EvalParams initial = evaluation::params();
+    if (!initPath.empty() && (!evaluation::loadParams(initPath, initial) || !evaluation::setParams(initial))) {
+        cerr << "could not load " << initPath << " as evaluation parameters" << endl;
+        return 1;
+    }
+
+    texel::Dataset data;
+    if (!data.open(dataPath)) {
+        cerr << "could not map " << dataPath << " as packed self-play records" << endl;
+        return 1;
+    }
+
+    auto start = steady_clock::now();
+    vector<texel::Sample> samples = texel::prepareSamples(data, limit, threads);
+    cerr << samples.size() << " positions resolved to quiet leaves in " << secondsSince(start) << "s" << endl;
+    if (samples.empty()) return 1;
+
+    texel::Params params = texel::fromEvalParams(initial);
+    start = steady_clock::now();
+    // k is fitted against the results alone, then scales the search scores
+    // blended into the targets the same way the loss scales the eval
+    double k = texel::fitScalingConstant(params, samples, threads);
+    cerr << "k = " << k << " (" << secondsSince(start) << "s)" << endl;
+    if (lambda > 0.0) texel::blendTargets(samples, lambda, k);
+
+    // Adam over both phases of every term
+    texel::Params m{}, v{}, gradient;
+    const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+    double loss = texel::computeLoss(params, samples, k, threads);
+    cerr << "initial loss " << loss << endl;
+
+    for (int epoch = 1; epoch <= epochs; ++epoch) {
+        auto epochStart = steady_clock::now();
+        loss = texel::computeLoss(params, samples, k, threads, &gradient);
+        double correction1 = 1.0 - pow(beta1, epoch);
+        double correction2 = 1.0 - pow(beta2, epoch);
+        for (int term = 0; term < texel::NUM_TERMS; ++term) {
+            double* values[2] = {&params.mg[term], &params.eg[term]};
+            double* moments[2] = {&m.mg[term], &m.eg[term]};
+            double* variances[2] = {&v.mg[term], &v.eg[term]};
+            double grads[2] = {gradient.mg[term], gradient.eg[term]};
+            for (int phase = 0; phase < 2; ++phase) {
+                *moments[phase] = beta1 * *moments[phase] + (1.0 - beta1) * grads[phase];
+                *variances[phase] = beta2 * *variances[phase] + (1.0 - beta2) * grads[phase] * grads[phase];
+                *values[phase] -= learningRate * (*moments[phase] / correction1) /
+                                  (sqrt(*variances[phase] / correction2) + epsilon);
+            }
+        }
+
+        double seconds = secondsSince(epochStart);
+        cerr << "epoch " << epoch << " loss " << loss << " (" << seconds << "s, "
+             << static_cast<long long>(seconds > 0 ? samples.size() / seconds : 0.0) << " positions/s)" << endl;
+    }
+
+    loss = texel::computeLoss(params, samples, k, threads);
+    string comment = to_string(samples.size()) + " positions, k " + to_string(k) + ", loss " + to_string(loss);
+    if (!texel::writeHeader(outputPath, params, comment)) {
+        cerr << "could not write " << outputPath << endl;
+        return 1;
+    }
+    if (!paramsPath.empty() && !evaluation::saveParams(paramsPath, texel::toEvalParams(params))) {
+        cerr << "could not write " << paramsPath << endl;
+        return 1;
+    }
+    cerr << "final loss " << loss << ", wrote " << outputPath << (paramsPath.empty() ? "" : " and " + paramsPath) << endl;
+    return 0;
+}